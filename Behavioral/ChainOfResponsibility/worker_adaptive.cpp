@@ -0,0 +1,622 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+enum class Task
+{
+    CustomerIssue,
+    Programming,
+    HardProgramming,
+    MoneyIssue,
+    M_And_A,
+    ImpossibleTask
+};
+
+constexpr std::size_t kTaskCount = static_cast<std::size_t>(Task::ImpossibleTask) + 1;
+
+inline std::string GetNameOfTask(Task task)
+{
+    switch (task)
+    {
+    case Task::CustomerIssue:
+        return "CustomerIssue";
+    case Task::Programming:
+        return "Programming";
+    case Task::HardProgramming:
+        return "HardProgramming";
+    case Task::MoneyIssue:
+        return "MoneyIssue";
+    case Task::M_And_A:
+        return "M_And_A";
+    case Task::ImpossibleTask:
+        return "ImpossibleTask";
+    default:
+        throw std::invalid_argument("");
+    }
+}
+
+/*
+    Worker 별 통계를 thread 마다 따로 모아두고, 요청이 있을 때만 합산합니다.
+    각 thread 는 자신의 counter 만 갱신하므로, 갱신은 relaxed load/store 만으로 이루어집니다.
+    (lock 이 붙은 read-modify-write 명령이 아니므로, 일반 변수의 증가와 비용이 같습니다.)
+    다른 thread 에서 합산할 때 값이 찢어지지 않도록 하기 위해서만 atomic 타입을 사용합니다.
+*/
+class WorkerStatistics
+{
+public:
+    static constexpr std::size_t kMaxWorkers = 64;  //< 동시에 살아있을 수 있는 Worker 의 수
+    static constexpr std::size_t kHopBuckets = 16;  //< 마지막 bucket 은 그 이상의 hop 을 모두 포함합니다.
+
+    struct Counters
+    {
+        std::uint64_t seen;
+        std::uint64_t handled;
+        std::uint64_t passed;
+    };
+
+    static WorkerStatistics& Instance()
+    {
+        static WorkerStatistics instance;
+        return instance;
+    }
+
+    WorkerStatistics(WorkerStatistics const&) = delete;
+    WorkerStatistics& operator=(WorkerStatistics const&) = delete;
+
+    std::size_t AllocateWorkerId()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!freeWorkerIds_.empty())
+        {
+            auto id = freeWorkerIds_.back();
+            freeWorkerIds_.pop_back();
+            return id;
+        }
+        if (nextWorkerId_ >= kMaxWorkers)
+        {
+            throw std::runtime_error("Too many workers.");
+        }
+        return nextWorkerId_++;
+    }
+
+    // Worker 가 사라질 때 부릅니다. 다음에 이 id 를 받는 Worker 가 이전 통계를 물려받지 않도록 비웁니다.
+    // (이 Worker 로 Work 하는 thread 가 더 이상 없어야 합니다.)
+    void ReleaseWorkerId(std::size_t workerId)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto const& block : blocks_)
+        {
+            block->seen[workerId].store(0, std::memory_order_relaxed);
+            block->handled[workerId].store(0, std::memory_order_relaxed);
+            block->failed[workerId].store(0, std::memory_order_relaxed);
+            for (auto& counter : block->hops[workerId])
+            {
+                counter.store(0, std::memory_order_relaxed);
+            }
+        }
+        ++generations_[workerId];
+        freeWorkerIds_.push_back(workerId);
+    }
+
+    // id 가 해제될 때마다 증가하므로, (id, generation) 으로 Worker 를 구분할 수 있습니다.
+    std::uint64_t GetGeneration(std::size_t workerId)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return generations_[workerId];
+    }
+
+    void RecordSeen(std::size_t workerId) { Increment_(Local_().seen[workerId]); }
+    void RecordHandled(std::size_t workerId) { Increment_(Local_().handled[workerId]); }
+
+    // entryWorkerId 의 Worker 에서 시작된 Task 가 몇 번의 hop 만에 처리되었는지 기록합니다.
+    void RecordHops(std::size_t entryWorkerId, std::size_t hops)
+    {
+        Increment_(Local_().hops[entryWorkerId][std::min(hops, kHopBuckets - 1)]);
+    }
+
+    // entryWorkerId 의 Worker 에서 시작된 Task 를 체인의 누구도 처리하지 못했음을 기록합니다.
+    void RecordFailure(std::size_t entryWorkerId) { Increment_(Local_().failed[entryWorkerId]); }
+
+    Counters GetCounters(std::size_t workerId)
+    {
+        Counters counters{ 0, 0, 0 };
+        Aggregate_([&](Block_ const& block)
+        {
+            // handled 는 seen 보다 나중에 증가하므로 먼저 읽습니다. 그래도 순서가 보장되지는 않으므로 0 아래로는 내려가지 않게 합니다.
+            counters.handled += block.handled[workerId].load(std::memory_order_relaxed);
+            counters.seen += block.seen[workerId].load(std::memory_order_relaxed);
+        });
+        counters.passed = counters.seen > counters.handled ? counters.seen - counters.handled : 0;
+        return counters;
+    }
+
+    std::array<std::uint64_t, kHopBuckets> GetHopHistogram(std::size_t entryWorkerId)
+    {
+        std::array<std::uint64_t, kHopBuckets> histogram{};
+        Aggregate_([&](Block_ const& block)
+        {
+            for (std::size_t i = 0; i < kHopBuckets; ++i)
+            {
+                histogram[i] += block.hops[entryWorkerId][i].load(std::memory_order_relaxed);
+            }
+        });
+        return histogram;
+    }
+
+    std::uint64_t GetFailureCount(std::size_t entryWorkerId)
+    {
+        std::uint64_t count = 0;
+        Aggregate_([&](Block_ const& block)
+        {
+            count += block.failed[entryWorkerId].load(std::memory_order_relaxed);
+        });
+        return count;
+    }
+
+private:
+    using Counter_ = std::atomic<std::uint64_t>;
+
+    struct Block_
+    {
+        std::array<Counter_, kMaxWorkers> seen{};
+        std::array<Counter_, kMaxWorkers> handled{};
+        std::array<Counter_, kMaxWorkers> failed{};
+        std::array<std::array<Counter_, kHopBuckets>, kMaxWorkers> hops{};
+    };
+
+    // thread 가 종료되어도 합산 결과가 유지되도록, block 은 해제하지 않고 재사용합니다.
+    struct LocalBlock_
+    {
+        explicit LocalBlock_(WorkerStatistics& statistics)
+            : statistics(statistics), block(statistics.AcquireBlock_())
+        {}
+
+        ~LocalBlock_()
+        {
+            statistics.ReleaseBlock_(block);
+        }
+
+        WorkerStatistics& statistics;
+        Block_* block;
+    };
+
+    WorkerStatistics() = default;
+
+    static void Increment_(Counter_& counter)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    Block_& Local_()
+    {
+        thread_local LocalBlock_ local(*this);
+        return *local.block;
+    }
+
+    Block_* AcquireBlock_()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!freeBlocks_.empty())
+        {
+            auto* block = freeBlocks_.back();
+            freeBlocks_.pop_back();
+            return block;
+        }
+        blocks_.push_back(std::make_unique<Block_>());
+        return blocks_.back().get();
+    }
+
+    void ReleaseBlock_(Block_* block)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        freeBlocks_.push_back(block);
+    }
+
+    template <typename Func>
+    void Aggregate_(Func&& func)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto const& block : blocks_)
+        {
+            func(*block);
+        }
+    }
+
+    std::mutex mutex_;
+    std::size_t nextWorkerId_{ 0 };
+    std::vector<std::size_t> freeWorkerIds_;
+    std::vector<std::unique_ptr<Block_>> blocks_;
+    std::vector<Block_*> freeBlocks_;
+    std::array<std::uint64_t, kMaxWorkers> generations_{};
+};
+
+class Worker
+{
+public:
+    explicit Worker(Worker* successor)
+        : successor_(successor), id_(WorkerStatistics::Instance().AllocateWorkerId()),
+          generation_(WorkerStatistics::Instance().GetGeneration(id_))
+    {}
+
+    virtual ~Worker()
+    {
+        WorkerStatistics::Instance().ReleaseWorkerId(id_);
+    }
+
+    void Work(Task task)
+    {
+        auto& statistics = WorkerStatistics::Instance();
+        std::size_t hops = 1;
+
+        for (Worker* worker = this; worker; worker = worker->successor_, ++hops)
+        {
+            statistics.RecordSeen(worker->id_);
+
+            if (worker->WorkImpl_(task))
+            {
+                statistics.RecordHandled(worker->id_);
+                statistics.RecordHops(id_, hops);
+                return;
+            }
+        }
+
+        statistics.RecordFailure(id_);
+        std::cout << "Fail to handle task. (" << GetNameOfTask(task) << ")" << std::endl;
+    }
+
+    Worker* ChangeSuccessor(Worker* successor)
+    {
+        Worker* old = successor_;
+        successor_ = successor;
+        return old;
+    }
+
+    Worker* GetSuccessor() const { return successor_; }
+    std::size_t GetId() const { return id_; }
+    std::uint64_t GetGeneration() const { return generation_; }
+
+    /*
+        다른 reorderable Worker 들과 처리하는 Task 가 겹치지 않는 Worker 만 reorderable 로
+        설정해야 합니다. 그래야 순서가 바뀌어도 체인 전체의 동작이 같습니다.
+    */
+    bool IsReorderable() const { return isReorderable_; }
+    void SetReorderable(bool isReorderable) { isReorderable_ = isReorderable; }
+
+    WorkerStatistics::Counters GetCounters() const
+    {
+        return WorkerStatistics::Instance().GetCounters(id_);
+    }
+
+private:
+    virtual bool WorkImpl_(Task task) = 0;
+
+    Worker* successor_;
+    std::size_t id_;
+    std::uint64_t generation_;
+    bool isReorderable_{ false };
+};
+
+/*
+    체인의 head 를 들고 있으면서, 각 Worker 가 처리한 Task 수에 따라 체인의 순서를 바꿉니다.
+    reorderable 이 아닌 Worker 는 자리를 옮기지 않으며, 그 사이의 구간 안에서만
+    reorderable Worker 들을 지난 Reorder 이후로 처리한 Task 수가 많은 순서로 정렬합니다.
+    adaptive 모드에서는 reorderInterval 개의 Task 마다 자동으로 Reorder 를 수행합니다.
+    (Reorder 는 체인을 다시 연결하므로, 다른 thread 의 Work 와 동시에 호출되면 안 됩니다.)
+*/
+class WorkerChain
+{
+public:
+    explicit WorkerChain(Worker& head)
+        : head_(&head)
+    {}
+
+    void Work(Task task)
+    {
+        head_->Work(task);
+
+        if (reorderInterval_ && ++workCount_ % reorderInterval_ == 0)
+        {
+            Reorder();
+        }
+    }
+
+    void EnableAdaptive(std::uint64_t reorderInterval)
+    {
+        reorderInterval_ = reorderInterval;
+    }
+
+    void Reorder()
+    {
+        std::vector<Worker*> workers;
+        for (Worker* worker = head_; worker; worker = worker->GetSuccessor())
+        {
+            workers.push_back(worker);
+        }
+
+        std::vector<std::uint64_t> recentHandled(WorkerStatistics::kMaxWorkers, 0);
+        for (auto* worker : workers)
+        {
+            auto id = worker->GetId();
+            auto handled = worker->GetCounters().handled;
+            // id 가 다른 Worker 에게 재사용되었다면 통계가 비워졌으므로, 기준을 0 부터 다시 잡습니다.
+            if (lastGeneration_[id] != worker->GetGeneration())
+            {
+                lastGeneration_[id] = worker->GetGeneration();
+                lastHandled_[id] = 0;
+            }
+            recentHandled[id] = handled - lastHandled_[id];
+            lastHandled_[id] = handled;
+        }
+
+        auto begin = workers.begin();
+        while (begin != workers.end())
+        {
+            begin = std::find_if(begin, workers.end(), [](Worker* worker) { return worker->IsReorderable(); });
+            auto end = std::find_if(begin, workers.end(), [](Worker* worker) { return !worker->IsReorderable(); });
+
+            std::stable_sort(begin, end, [&](Worker* lhs, Worker* rhs)
+            {
+                return recentHandled[lhs->GetId()] > recentHandled[rhs->GetId()];
+            });
+
+            begin = end;
+        }
+
+        for (std::size_t i = 0; i < workers.size(); ++i)
+        {
+            workers[i]->ChangeSuccessor(i + 1 < workers.size() ? workers[i + 1] : nullptr);
+        }
+        head_ = workers.front();
+    }
+
+    Worker& GetHead() const { return *head_; }
+
+    // 이 체인으로 들어온 Task 들의 평균 hop 수. (head 가 바뀌었다면 바뀐 뒤의 것만 셉니다.)
+    double GetAverageHops() const
+    {
+        auto histogram = WorkerStatistics::Instance().GetHopHistogram(head_->GetId());
+        std::uint64_t count = 0, total = 0;
+        for (std::size_t i = 0; i < histogram.size(); ++i)
+        {
+            count += histogram[i];
+            total += histogram[i] * i;
+        }
+        return count ? static_cast<double>(total) / count : 0.0;
+    }
+
+    // 체인의 누구도 처리하지 못한 Task 의 수. (GetAverageHops 에는 포함되지 않습니다.)
+    std::uint64_t GetFailureCount() const
+    {
+        return WorkerStatistics::Instance().GetFailureCount(head_->GetId());
+    }
+
+private:
+    Worker* head_;
+    std::uint64_t reorderInterval_{ 0 };
+    std::uint64_t workCount_{ 0 };
+    std::array<std::uint64_t, WorkerStatistics::kMaxWorkers> lastHandled_{};
+    std::array<std::uint64_t, WorkerStatistics::kMaxWorkers> lastGeneration_{};    //< lastHandled_ 를 기록한 Worker 의 generation
+};
+
+class CustomerSupporter : public Worker
+{
+public:
+    using Worker::Worker;
+
+private:
+    bool WorkImpl_(Task task) override
+    {
+        switch (task)
+        {
+        case Task::CustomerIssue:
+            std::cout << "[CustomerSupporter] Resolve customer issue." << std::endl;
+            return true;
+
+        default:
+            return false;
+        }
+    }
+};
+
+class SoftwareEngineer : public Worker
+{
+public:
+    using Worker::Worker;
+
+    void Train()
+    {
+        isTrained_ = true;
+    }
+
+private:
+    bool WorkImpl_(Task task) override
+    {
+        switch (task)
+        {
+        case Task::Programming:
+            std::cout << "[SoftwareEngineer] Programming." << std::endl;
+            return true;
+
+        case Task::HardProgramming:
+            if (isTrained_)
+            {
+                std::cout << "[SoftwareEngineer] Successfully solve hard problem!" << std::endl;
+                return true;
+            }
+            else
+            {
+                std::cout << "[SoftwareEngineer] Try to solve hard problem. But failed." << std::endl;
+                return false;
+            }
+
+        default:
+            return false;
+        }
+    }
+
+    bool isTrained_{ false };
+};
+
+class CEO : public Worker
+{
+public:
+    using Worker::Worker;
+
+private:
+    bool WorkImpl_(Task task) override
+    {
+        switch (task)
+        {
+        case Task::MoneyIssue:
+            std::cout << "[CEO] Resolve money issue." << std::endl;
+            return true;
+
+        case Task::M_And_A:
+            std::cout << "[CEO] Do M&A." << std::endl;
+            return true;
+
+        default:
+            return false;
+        }
+    }
+};
+
+class God : public Worker
+{
+public:
+    using Worker::Worker;
+
+private:
+    bool WorkImpl_(Task) override
+    {
+        std::cout << "[God] God can do anything!" << std::endl;
+        return true;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Benchmark 용 Worker. (한 종류의 Task 만 조용히 처리합니다.)
+
+class Specialist : public Worker
+{
+public:
+    Specialist(Worker* successor, Task task)
+        : Worker(successor), task_(task)
+    {
+        SetReorderable(true);
+    }
+
+private:
+    bool WorkImpl_(Task task) override { return task == task_; }
+
+    Task task_;
+};
+
+void PrintCounters(std::string const& name, Worker const& worker)
+{
+    auto counters = worker.GetCounters();
+    std::cout << "  " << name << " : seen " << counters.seen << ", handled " << counters.handled
+        << ", passed " << counters.passed << std::endl;
+}
+
+// 90% 가 Programming 인 치우친 workload 를 처리합니다.
+double RunSkewedWorkload(WorkerChain& chain, std::size_t taskCount)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < taskCount; ++i)
+    {
+        chain.Work(i % 10 == 0 ? Task::CustomerIssue : Task::Programming);
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main()
+{
+    CEO ceo(nullptr);
+    SoftwareEngineer se(&ceo);
+    CustomerSupporter supporter{ &se };
+    God god(nullptr);
+    ceo.ChangeSuccessor(&god);
+
+    // God 는 모든 Task 를 처리하므로, 항상 마지막에 있어야 합니다.
+    supporter.SetReorderable(true);
+    se.SetReorderable(true);
+    ceo.SetReorderable(true);
+
+    WorkerChain chain(supporter);
+
+    std::cout << "----------------------" << std::endl;
+    for (auto task : { Task::Programming, Task::Programming, Task::CustomerIssue,
+                       Task::Programming, Task::MoneyIssue, Task::ImpossibleTask })
+    {
+        chain.Work(task);
+    }
+    PrintCounters("CustomerSupporter", supporter);
+    PrintCounters("SoftwareEngineer ", se);
+    PrintCounters("CEO              ", ceo);
+    PrintCounters("God              ", god);
+    std::cout << "  average hops : " << chain.GetAverageHops() << ", failed " << chain.GetFailureCount() << std::endl;
+
+    std::cout << "Reorder chain by hit rates!" << std::endl;
+    chain.Reorder();
+    chain.Work(Task::Programming);
+    chain.Work(Task::CustomerIssue);
+    std::cout << "  average hops : " << chain.GetAverageHops() << std::endl;
+
+    // Worker 의 id 는 재사용되므로, kMaxWorkers 보다 많은 Worker 를 차례로 만들고 없앨 수 있습니다.
+    bool isRecycled = true;
+    for (std::size_t i = 0; i < 10 * WorkerStatistics::kMaxWorkers; ++i)
+    {
+        Specialist temporary(nullptr, Task::MoneyIssue);
+        isRecycled = isRecycled && temporary.GetCounters().seen == 0;
+        temporary.Work(Task::MoneyIssue);
+    }
+    std::cout << "Worker id recycling : " << (isRecycled ? "passed" : "FAILED") << std::endl;
+
+    // 재사용된 id 를 받은 Worker 는, 이전 Worker 가 마지막으로 기록한 수와 상관없이 자신이 처리한 수로 정렬되어야 합니다.
+    bool isRankedByNewWorker;
+    {
+        Specialist money(nullptr, Task::MoneyIssue);
+        WorkerChain recycledChain(money);
+        {
+            Specialist old(nullptr, Task::Programming);
+            money.ChangeSuccessor(&old);
+            for (int i = 0; i < 10; ++i) recycledChain.Work(Task::MoneyIssue);
+            for (int i = 0; i < 5; ++i) recycledChain.Work(Task::Programming);
+            recycledChain.Reorder();
+            money.ChangeSuccessor(nullptr);
+        }
+
+        Specialist recycled(nullptr, Task::Programming);   //< old 의 id 를 다시 받습니다.
+        money.ChangeSuccessor(&recycled);
+        for (int i = 0; i < 3; ++i) recycledChain.Work(Task::MoneyIssue);
+        for (int i = 0; i < 7; ++i) recycledChain.Work(Task::Programming);
+        recycledChain.Reorder();
+        isRankedByNewWorker = &recycledChain.GetHead() == &recycled;
+    }
+    std::cout << "Reorder after id recycling : " << (isRankedByNewWorker ? "passed" : "FAILED") << std::endl;
+
+    std::cout << "---- Skewed workload (1,000,000 tasks) ----" << std::endl;
+    Specialist programmer(nullptr, Task::Programming);
+    Specialist treasurer(&programmer, Task::MoneyIssue);
+    Specialist negotiator(&treasurer, Task::M_And_A);
+    Specialist supporter_2(&negotiator, Task::CustomerIssue);
+
+    WorkerChain staticChain(supporter_2);
+    auto staticTime = RunSkewedWorkload(staticChain, 1000000);
+    std::cout << "static   : " << staticTime << " ms, average hops " << staticChain.GetAverageHops() << std::endl;
+
+    WorkerChain adaptiveChain(supporter_2);
+    adaptiveChain.EnableAdaptive(10000);
+    auto adaptiveTime = RunSkewedWorkload(adaptiveChain, 1000000);
+    std::cout << "adaptive : " << adaptiveTime << " ms, average hops " << adaptiveChain.GetAverageHops() << std::endl;
+}
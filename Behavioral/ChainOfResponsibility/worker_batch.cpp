@@ -0,0 +1,356 @@
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+enum class Task
+{
+    CustomerIssue,
+    Programming,
+    HardProgramming,
+    MoneyIssue,
+    M_And_A,
+    ImpossibleTask
+};
+
+constexpr std::size_t kTaskCount = static_cast<std::size_t>(Task::ImpossibleTask) + 1;
+
+inline std::string GetNameOfTask(Task task)
+{
+    switch (task)
+    {
+    case Task::CustomerIssue:
+        return "CustomerIssue";
+    case Task::Programming:
+        return "Programming";
+    case Task::HardProgramming:
+        return "HardProgramming";
+    case Task::MoneyIssue:
+        return "MoneyIssue";
+    case Task::M_And_A:
+        return "M_And_A";
+    case Task::ImpossibleTask:
+        return "ImpossibleTask";
+    default:
+        throw std::invalid_argument("");
+    }
+}
+
+/*
+    하나의 batch 를 Task 종류별로 나눈 것입니다.
+    각 종류마다, 원래 batch 에서의 index 목록을 가지고 있습니다.
+*/
+class TaskBatch
+{
+public:
+    TaskBatch(Task const* tasks, std::size_t count)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            indices_[static_cast<std::size_t>(tasks[i])].push_back(i);
+        }
+    }
+
+    std::size_t Count(Task task) const
+    {
+        return indices_[static_cast<std::size_t>(task)].size();
+    }
+
+    bool Empty() const
+    {
+        for (auto const& indices : indices_)
+        {
+            if (!indices.empty())
+                return false;
+        }
+        return true;
+    }
+
+    // 해당 종류의 Task 들을 모두 처리했음을 표시하고, 처리한 개수를 반환합니다.
+    std::size_t Take(Task task)
+    {
+        auto& indices = indices_[static_cast<std::size_t>(task)];
+        auto count = indices.size();
+        indices.clear();
+        return count;
+    }
+
+    // 남아있는 (처리되지 못한) Task 들의 index 를 오름차순으로 반환합니다.
+    std::vector<std::size_t> RemainingIndices() const
+    {
+        std::vector<std::size_t> remaining;
+        std::vector<std::size_t> merged;
+
+        for (auto const& indices : indices_)
+        {
+            merged.clear();
+            merged.reserve(remaining.size() + indices.size());
+            std::size_t i = 0, j = 0;
+            while (i < remaining.size() && j < indices.size())
+                merged.push_back(remaining[i] < indices[j] ? remaining[i++] : indices[j++]);
+            merged.insert(merged.end(), remaining.begin() + i, remaining.end());
+            merged.insert(merged.end(), indices.begin() + j, indices.end());
+            remaining.swap(merged);
+        }
+
+        return remaining;
+    }
+
+private:
+    std::array<std::vector<std::size_t>, kTaskCount> indices_;
+};
+
+class Worker
+{
+public:
+    explicit Worker(Worker* successor)
+        : successor_(successor)
+    {}
+
+    virtual ~Worker() = default;
+
+    // Task 하나는 batch 를 만들지 않고, 체인을 직접 따라가며 처리합니다. (할당이 없습니다.)
+    void Work(Task task)
+    {
+        if (WorkImpl_(task))
+        {
+            return;
+        }
+
+        if (successor_)
+        {
+            successor_->Work(task);
+        }
+        else
+        {
+            std::cout << "Fail to handle task. (" << GetNameOfTask(task) << ")" << std::endl;
+        }
+    }
+
+    /*
+        batch 전체를 한 번에 처리합니다.
+        각 Worker 는 자신이 처리할 수 있는 종류의 Task 들을 통째로 가져가고, 나머지만
+        successor 에게 넘깁니다. 즉, Task 하나당 hop 마다가 아니라, batch 하나당 Worker 마다
+        한 번의 가상 함수 호출만 일어납니다.
+        처리되지 못한 Task 들의 index 목록을 반환합니다.
+    */
+    std::vector<std::size_t> WorkBatch(Task const* tasks, std::size_t count)
+    {
+        TaskBatch batch(tasks, count);
+
+        for (Worker* worker = this; worker && !batch.Empty(); worker = worker->successor_)
+        {
+            worker->WorkBatchImpl_(batch);
+        }
+
+        return batch.RemainingIndices();
+    }
+
+    std::vector<std::size_t> WorkBatch(std::vector<Task> const& tasks)
+    {
+        return WorkBatch(tasks.data(), tasks.size());
+    }
+
+    Worker* ChangeSuccessor(Worker* successor)
+    {
+        Worker* old = successor_;
+        successor_ = successor;
+        return old;
+    }
+
+private:
+    virtual bool WorkImpl_(Task task) = 0;
+    virtual void WorkBatchImpl_(TaskBatch& batch) = 0;
+
+    Worker* successor_;
+};
+
+class CustomerSupporter : public Worker
+{
+public:
+    using Worker::Worker;
+
+private:
+    bool WorkImpl_(Task task) override
+    {
+        switch (task)
+        {
+        case Task::CustomerIssue:
+            std::cout << "[CustomerSupporter] Resolve customer issue." << std::endl;
+            return true;
+
+        default:
+            return false;
+        }
+    }
+
+    void WorkBatchImpl_(TaskBatch& batch) override
+    {
+        if (auto count = batch.Take(Task::CustomerIssue))
+        {
+            std::cout << "[CustomerSupporter] Resolve customer issue. (x" << count << ")" << std::endl;
+        }
+    }
+};
+
+class SoftwareEngineer : public Worker
+{
+public:
+    using Worker::Worker;
+
+    void Train()
+    {
+        isTrained_ = true;
+    }
+
+private:
+    bool WorkImpl_(Task task) override
+    {
+        switch (task)
+        {
+        case Task::Programming:
+            std::cout << "[SoftwareEngineer] Programming." << std::endl;
+            return true;
+
+        case Task::HardProgramming:
+            if (isTrained_)
+            {
+                std::cout << "[SoftwareEngineer] Successfully solve hard problem!" << std::endl;
+                return true;
+            }
+            else
+            {
+                std::cout << "[SoftwareEngineer] Try to solve hard problem. But failed." << std::endl;
+                return false;
+            }
+
+        default:
+            return false;
+        }
+    }
+
+    void WorkBatchImpl_(TaskBatch& batch) override
+    {
+        if (auto count = batch.Take(Task::Programming))
+        {
+            std::cout << "[SoftwareEngineer] Programming. (x" << count << ")" << std::endl;
+        }
+
+        if (auto count = batch.Count(Task::HardProgramming))
+        {
+            if (isTrained_)
+            {
+                batch.Take(Task::HardProgramming);
+                std::cout << "[SoftwareEngineer] Successfully solve hard problem! (x" << count << ")" << std::endl;
+            }
+            else
+            {
+                std::cout << "[SoftwareEngineer] Try to solve hard problem. But failed. (x" << count << ")" << std::endl;
+            }
+        }
+    }
+
+    bool isTrained_{ false };
+};
+
+class CEO : public Worker
+{
+public:
+    using Worker::Worker;
+
+private:
+    bool WorkImpl_(Task task) override
+    {
+        switch (task)
+        {
+        case Task::MoneyIssue:
+            std::cout << "[CEO] Resolve money issue." << std::endl;
+            return true;
+
+        case Task::M_And_A:
+            std::cout << "[CEO] Do M&A." << std::endl;
+            return true;
+
+        default:
+            return false;
+        }
+    }
+
+    void WorkBatchImpl_(TaskBatch& batch) override
+    {
+        if (auto count = batch.Take(Task::MoneyIssue))
+        {
+            std::cout << "[CEO] Resolve money issue. (x" << count << ")" << std::endl;
+        }
+
+        if (auto count = batch.Take(Task::M_And_A))
+        {
+            std::cout << "[CEO] Do M&A. (x" << count << ")" << std::endl;
+        }
+    }
+};
+
+class God : public Worker
+{
+public:
+    using Worker::Worker;
+
+private:
+    bool WorkImpl_(Task) override
+    {
+        std::cout << "[God] God can do anything!" << std::endl;
+        return true;
+    }
+
+    void WorkBatchImpl_(TaskBatch& batch) override
+    {
+        std::size_t count = 0;
+
+        for (std::size_t i = 0; i < kTaskCount; ++i)
+        {
+            count += batch.Take(static_cast<Task>(i));
+        }
+
+        std::cout << "[God] God can do anything! (x" << count << ")" << std::endl;
+    }
+};
+
+void PrintUnhandled(std::vector<Task> const& tasks, std::vector<std::size_t> const& unhandled)
+{
+    std::cout << "Unhandled tasks : " << unhandled.size() << " [";
+    for (auto index : unhandled)
+    {
+        std::cout << " " << index << ":" << GetNameOfTask(tasks[index]);
+    }
+    std::cout << " ]" << std::endl;
+}
+
+int main()
+{
+    CEO ceo(nullptr);
+    SoftwareEngineer se(&ceo);
+    CustomerSupporter supporter{ &se };
+
+    std::vector<Task> tasks{
+        Task::CustomerIssue, Task::Programming, Task::HardProgramming,
+        Task::MoneyIssue, Task::Programming, Task::ImpossibleTask,
+        Task::HardProgramming, Task::M_And_A, Task::CustomerIssue
+    };
+
+    std::cout << "----------------------" << std::endl;
+    PrintUnhandled(tasks, supporter.WorkBatch(tasks));
+
+    std::cout << "Train software engineer!" << std::endl;
+    se.Train();
+    PrintUnhandled(tasks, supporter.WorkBatch(tasks));
+
+    std::cout << "Change ceo's successor to 'GOD'!" << std::endl;
+    God god(nullptr);
+    ceo.ChangeSuccessor(&god);
+    PrintUnhandled(tasks, supporter.WorkBatch(tasks));
+
+    std::cout << "----------------------" << std::endl;
+    supporter.Work(Task::Programming);
+}
@@ -0,0 +1,515 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum class Task
+{
+    CustomerIssue,
+    Programming,
+    HardProgramming,
+    MoneyIssue,
+    M_And_A,
+    ImpossibleTask
+};
+
+constexpr std::size_t kTaskCount = static_cast<std::size_t>(Task::ImpossibleTask) + 1;
+
+inline std::string GetNameOfTask(Task task)
+{
+    switch (task)
+    {
+    case Task::CustomerIssue:
+        return "CustomerIssue";
+    case Task::Programming:
+        return "Programming";
+    case Task::HardProgramming:
+        return "HardProgramming";
+    case Task::MoneyIssue:
+        return "MoneyIssue";
+    case Task::M_And_A:
+        return "M_And_A";
+    case Task::ImpossibleTask:
+        return "ImpossibleTask";
+    default:
+        throw std::invalid_argument("");
+    }
+}
+
+class Worker;
+
+/*
+    Epoch 기반 메모리 회수 (Epoch-Based Reclamation)
+    Reader 는 체인을 탐색하는 동안 자신의 slot 에 현재 epoch 를 기록해두고,
+    끝나면 slot 을 비웁니다. (lock 을 잡지 않습니다.)
+    Writer 는 successor 를 교체한 후 epoch 를 증가시키고, 떼어낸 Worker 를 retire 목록에
+    넣어둡니다. 모든 reader 가 그 이후의 epoch 로 넘어가면 떼어낸 Worker 를 해제합니다.
+*/
+class EpochReclaimer
+{
+public:
+    static constexpr std::size_t kMaxReaderThreads = 64;
+
+    static EpochReclaimer& Instance()
+    {
+        static EpochReclaimer instance;
+        return instance;
+    }
+
+    EpochReclaimer(EpochReclaimer const&) = delete;
+    EpochReclaimer& operator=(EpochReclaimer const&) = delete;
+
+    class ReadGuard
+    {
+    public:
+        explicit ReadGuard(EpochReclaimer& reclaimer)
+            : slot_(reclaimer.GetSlot_())
+        {
+            slot_.store(reclaimer.epoch_.load());
+        }
+
+        ~ReadGuard()
+        {
+            slot_.store(0);
+        }
+
+        ReadGuard(ReadGuard const&) = delete;
+        ReadGuard& operator=(ReadGuard const&) = delete;
+
+    private:
+        std::atomic<std::uint64_t>& slot_;
+    };
+
+    // 체인에서 떼어낸 Worker 를 넘겨주면, 안전해지는 시점에 해제합니다.
+    void Retire(std::unique_ptr<Worker> worker);
+
+    // 현재 진행중인 모든 reader 가 빠져나갈 때까지 기다립니다.
+    void Synchronize()
+    {
+        auto epoch = epoch_.fetch_add(1) + 1;
+        while (!IsQuiescent_(epoch))
+        {
+            std::this_thread::yield();
+        }
+        Reclaim_();
+    }
+
+    std::size_t GetPendingCount()
+    {
+        std::lock_guard<std::mutex> lock(retireMutex_);
+        return retired_.size();
+    }
+
+private:
+    EpochReclaimer() = default;
+
+    struct alignas(64) Slot
+    {
+        std::atomic<std::uint64_t> epoch{ 0 };
+        std::atomic<bool> inUse{ false };
+    };
+
+    // thread 마다 하나의 slot 을 빌려 쓰고, thread 가 종료되면 반납합니다.
+    class SlotOwner
+    {
+    public:
+        explicit SlotOwner(EpochReclaimer& reclaimer)
+        {
+            for (auto& slot : reclaimer.slots_)
+            {
+                bool expected = false;
+                if (slot.inUse.compare_exchange_strong(expected, true))
+                {
+                    slot_ = &slot;
+                    return;
+                }
+            }
+            throw std::runtime_error("Too many reader threads.");
+        }
+
+        ~SlotOwner()
+        {
+            slot_->inUse.store(false);
+        }
+
+        std::atomic<std::uint64_t>& Epoch() { return slot_->epoch; }
+
+    private:
+        Slot* slot_{ nullptr };
+    };
+
+    std::atomic<std::uint64_t>& GetSlot_()
+    {
+        thread_local SlotOwner owner(*this);
+        return owner.Epoch();
+    }
+
+    bool IsQuiescent_(std::uint64_t epoch) const
+    {
+        for (auto const& slot : slots_)
+        {
+            auto readerEpoch = slot.epoch.load();
+            if (readerEpoch != 0 && readerEpoch < epoch)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void Reclaim_();
+
+    struct Retired
+    {
+        std::uint64_t epoch;
+        std::unique_ptr<Worker> worker;
+    };
+
+    std::atomic<std::uint64_t> epoch_{ 1 };
+    std::array<Slot, kMaxReaderThreads> slots_;
+
+    std::mutex retireMutex_;
+    std::vector<Retired> retired_;
+};
+
+class Worker
+{
+public:
+    explicit Worker(Worker* successor)
+        : successor_(successor)
+    {}
+
+    virtual ~Worker() = default;
+
+    /*
+        여러 thread 에서 동시에 호출될 수 있습니다.
+        체인을 따라가는 동안에는 lock 을 잡지 않으며, 도중에 ChangeSuccessor 가 호출되어도
+        교체 전 또는 교체 후의 체인 중 하나를 온전히 따라가게 됩니다.
+    */
+    bool Work(Task task)
+    {
+        EpochReclaimer::ReadGuard guard(EpochReclaimer::Instance());
+
+        for (Worker* worker = this; worker; worker = worker->successor_.load(std::memory_order_seq_cst))
+        {
+            if (worker->WorkImpl_(task))
+            {
+                return true;
+            }
+        }
+
+        std::cout << "Fail to handle task. (" << GetNameOfTask(task) << ")" << std::endl;
+        return false;
+    }
+
+    /*
+        이전 successor 를 반환합니다. 이전 successor 를 해제하려면, 직접 delete 하지 말고
+        EpochReclaimer::Retire() 에 넘겨야 합니다.
+    */
+    Worker* ChangeSuccessor(Worker* successor)
+    {
+        return successor_.exchange(successor);
+    }
+
+private:
+    virtual bool WorkImpl_(Task task) = 0;
+
+    std::atomic<Worker*> successor_;
+};
+
+void EpochReclaimer::Retire(std::unique_ptr<Worker> worker)
+{
+    auto epoch = epoch_.fetch_add(1) + 1;
+    {
+        std::lock_guard<std::mutex> lock(retireMutex_);
+        retired_.push_back({ epoch, std::move(worker) });
+    }
+    Reclaim_();
+}
+
+void EpochReclaimer::Reclaim_()
+{
+    std::vector<std::unique_ptr<Worker>> garbage;
+    {
+        std::lock_guard<std::mutex> lock(retireMutex_);
+        auto iter = retired_.begin();
+        while (iter != retired_.end())
+        {
+            if (IsQuiescent_(iter->epoch))
+            {
+                garbage.push_back(std::move(iter->worker));
+                iter = retired_.erase(iter);
+            }
+            else
+            {
+                ++iter;
+            }
+        }
+    }
+}
+
+class CustomerSupporter : public Worker
+{
+public:
+    using Worker::Worker;
+
+private:
+    bool WorkImpl_(Task task) override
+    {
+        switch (task)
+        {
+        case Task::CustomerIssue:
+            std::cout << "[CustomerSupporter] Resolve customer issue." << std::endl;
+            return true;
+
+        default:
+            return false;
+        }
+    }
+};
+
+class SoftwareEngineer : public Worker
+{
+public:
+    using Worker::Worker;
+
+    void Train()
+    {
+        isTrained_.store(true);
+    }
+
+private:
+    bool WorkImpl_(Task task) override
+    {
+        switch (task)
+        {
+        case Task::Programming:
+            std::cout << "[SoftwareEngineer] Programming." << std::endl;
+            return true;
+
+        case Task::HardProgramming:
+            if (isTrained_.load())
+            {
+                std::cout << "[SoftwareEngineer] Successfully solve hard problem!" << std::endl;
+                return true;
+            }
+            else
+            {
+                std::cout << "[SoftwareEngineer] Try to solve hard problem. But failed." << std::endl;
+                return false;
+            }
+
+        default:
+            return false;
+        }
+    }
+
+    std::atomic<bool> isTrained_{ false };
+};
+
+class CEO : public Worker
+{
+public:
+    using Worker::Worker;
+
+private:
+    bool WorkImpl_(Task task) override
+    {
+        switch (task)
+        {
+        case Task::MoneyIssue:
+            std::cout << "[CEO] Resolve money issue." << std::endl;
+            return true;
+
+        case Task::M_And_A:
+            std::cout << "[CEO] Do M&A." << std::endl;
+            return true;
+
+        default:
+            return false;
+        }
+    }
+};
+
+class God : public Worker
+{
+public:
+    using Worker::Worker;
+
+private:
+    bool WorkImpl_(Task) override
+    {
+        std::cout << "[God] God can do anything!" << std::endl;
+        return true;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Stress test 와 Benchmark 용 Worker 들. (아무것도 출력하지 않습니다.)
+
+// 아무 일도 처리하지 못하고 다음 Worker 에게 넘깁니다.
+class Intern : public Worker
+{
+public:
+    using Worker::Worker;
+
+private:
+    bool WorkImpl_(Task) override { return false; }
+};
+
+// 모든 일을 조용히 처리합니다. 해제된 후에 호출되면 assert 에 걸리고, (release build 에서는) false 를 반환합니다.
+class Secretary : public Worker
+{
+public:
+    using Worker::Worker;
+
+    ~Secretary() override { alive_ = kDead; }
+
+private:
+    static constexpr std::uint32_t kAlive = 0xA11CE;
+    static constexpr std::uint32_t kDead = 0xDEAD;
+
+    bool WorkImpl_(Task) override
+    {
+        assert(alive_ == kAlive);
+        return alive_ == kAlive;
+    }
+
+    volatile std::uint32_t alive_{ kAlive };
+};
+
+struct RunResult
+{
+    double tasksPerSecond;
+    std::uint64_t failureCount;     //< 처리되지 않은 task 수. (체인 끝의 Secretary 가 모두 처리하므로, 해제된 Secretary 를 호출한 횟수입니다.)
+    std::size_t pendingCount;       //< 끝난 뒤에도 회수되지 않고 남은 Worker 수
+};
+
+/*
+    readerCount 개의 thread 가 duration 동안 계속 Work 를 호출합니다.
+    swapWriter 가 true 이면, writer thread 가 1ms (1kHz) 마다 체인 끝의 Secretary 를
+    새 것으로 교체하고, 이전 것은 EpochReclaimer 에 retire 합니다.
+*/
+RunResult RunReaders(std::size_t readerCount, std::chrono::milliseconds duration, bool swapWriter)
+{
+    auto tail = std::make_unique<Secretary>(nullptr);
+    Intern intern_3(tail.get());
+    Intern intern_2(&intern_3);
+    Intern intern_1(&intern_2);
+
+    std::atomic<bool> stop{ false };
+    std::atomic<std::uint64_t> totalHandled{ 0 };
+    std::atomic<std::uint64_t> totalFailed{ 0 };
+    std::uint64_t swapCount = 0;
+
+    std::vector<std::thread> readers;
+    for (std::size_t i = 0; i < readerCount; ++i)
+    {
+        readers.emplace_back([&, i]
+        {
+            std::uint64_t handled = 0;
+            std::uint64_t failed = 0;
+            std::size_t taskIndex = i;
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                if (intern_1.Work(static_cast<Task>(taskIndex++ % kTaskCount)))
+                    ++handled;
+                else
+                    ++failed;
+            }
+            totalHandled += handled;
+            totalFailed += failed;
+        });
+    }
+
+    std::thread writer;
+    if (swapWriter)
+    {
+        writer = std::thread([&]
+        {
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                auto newTail = std::make_unique<Secretary>(nullptr);
+                intern_3.ChangeSuccessor(newTail.get());
+                EpochReclaimer::Instance().Retire(std::move(tail));
+                tail = std::move(newTail);
+                ++swapCount;
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        });
+    }
+
+    std::this_thread::sleep_for(duration);
+    stop = true;
+
+    for (auto& reader : readers)
+    {
+        reader.join();
+    }
+    if (writer.joinable())
+    {
+        writer.join();
+    }
+
+    EpochReclaimer::Instance().Synchronize();
+
+    if (swapWriter)
+    {
+        std::cout << "    (writer swapped successor " << swapCount << " times)" << std::endl;
+    }
+
+    auto seconds = std::chrono::duration<double>(duration).count();
+    return { totalHandled.load() / seconds, totalFailed.load(), EpochReclaimer::Instance().GetPendingCount() };
+}
+
+/*
+    Worker::successor_ 를 atomic pointer 로 만들고, epoch 기반 메모리 회수를 사용하여
+    여러 reader (Work 호출) 와 하나의 writer (ChangeSuccessor 호출) 가 동시에 체인을
+    사용할 수 있도록 합니다. reader 는 lock 을 전혀 잡지 않습니다.
+*/
+int main()
+{
+    CEO ceo(nullptr);
+    SoftwareEngineer se(&ceo);
+    CustomerSupporter supporter{ &se };
+
+    std::cout << "----------------------" << std::endl;
+    supporter.Work(Task::CustomerIssue);
+    supporter.Work(Task::Programming);
+    supporter.Work(Task::HardProgramming);
+
+    std::cout << "Train software engineer!" << std::endl;
+    se.Train();
+    supporter.Work(Task::HardProgramming);
+    supporter.Work(Task::MoneyIssue);
+    supporter.Work(Task::M_And_A);
+    supporter.Work(Task::ImpossibleTask);
+
+    std::cout << "Change ceo's successor to 'GOD'!" << std::endl;
+    God god(nullptr);
+    ceo.ChangeSuccessor(&god);
+    supporter.Work(Task::ImpossibleTask);
+
+    auto readerCount = std::max(3u, std::thread::hardware_concurrency()) - 1;
+
+    std::cout << "---- Stress test ----" << std::endl;
+    auto result = RunReaders(readerCount, std::chrono::milliseconds(500), true);
+    std::cout << result.failureCount << " tasks hit a freed worker, " << result.pendingCount << " workers left unreclaimed -> "
+        << (result.failureCount == 0 && result.pendingCount == 0 ? "correct" : "WRONG") << std::endl;
+
+    std::cout << "---- Benchmark (" << readerCount << " readers) ----" << std::endl;
+    auto withoutWriter = RunReaders(readerCount, std::chrono::milliseconds(300), false);
+    std::cout << "without writer : " << withoutWriter.tasksPerSecond << " tasks/s" << std::endl;
+    auto withWriter = RunReaders(readerCount, std::chrono::milliseconds(300), true);
+    std::cout << "with writer    : " << withWriter.tasksPerSecond << " tasks/s" << std::endl;
+}
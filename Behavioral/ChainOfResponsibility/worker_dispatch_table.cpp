@@ -0,0 +1,401 @@
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+enum class Task
+{
+    CustomerIssue,
+    Programming,
+    HardProgramming,
+    MoneyIssue,
+    M_And_A,
+    ImpossibleTask
+};
+
+constexpr std::size_t kTaskCount = static_cast<std::size_t>(Task::ImpossibleTask) + 1;
+
+inline std::string GetNameOfTask(Task task)
+{
+    switch (task)
+    {
+    case Task::CustomerIssue:
+        return "CustomerIssue";
+    case Task::Programming:
+        return "Programming";
+    case Task::HardProgramming:
+        return "HardProgramming";
+    case Task::MoneyIssue:
+        return "MoneyIssue";
+    case Task::M_And_A:
+        return "M_And_A";
+    case Task::ImpossibleTask:
+        return "ImpossibleTask";
+    default:
+        throw std::invalid_argument("");
+    }
+}
+
+class Worker
+{
+public:
+    explicit Worker(Worker* successor)
+        : successor_(successor)
+    {}
+
+    // table 에 남아있는 이 Worker 를 가리키는 항목이 다시 쓰이지 않도록, 체인들을 무효화합니다.
+    virtual ~Worker()
+    {
+        InvalidateChains_();
+    }
+
+    void Work(Task task)
+    {
+        if (WorkImpl_(task))
+        {
+            return;
+        }
+
+        if (successor_)
+        {
+            successor_->Work(task);
+        }
+        else
+        {
+            std::cout << "Fail to handle task. (" << GetNameOfTask(task) << ")" << std::endl;
+        }
+    }
+
+    Worker* ChangeSuccessor(Worker* successor)
+    {
+        Worker* old = successor_;
+        successor_ = successor;
+        InvalidateChains_();
+        return old;
+    }
+
+    // 체인의 구성이나 Worker의 능력이 바뀔 때마다 증가합니다.
+    static std::uint64_t GetChainGeneration()
+    {
+        return ChainGeneration_();
+    }
+
+protected:
+    static void InvalidateChains_()
+    {
+        ++ChainGeneration_();
+    }
+
+private:
+    friend class WorkerDispatchTable;
+
+    static std::uint64_t& ChainGeneration_()
+    {
+        static std::uint64_t generation{ 0 };
+        return generation;
+    }
+
+    // 부수효과 없이, 주어진 task를 처리할 수 있는지만 알려줍니다.
+    virtual bool CanHandle_(Task task) const = 0;
+    virtual bool WorkImpl_(Task task) = 0;
+
+    Worker* successor_;
+};
+
+/*
+    체인의 head 로부터 각 Task 를 최종적으로 처리하게 될 Worker 를 미리 찾아서
+    Task 별 jump table 에 저장해둡니다.
+    Work() 호출 시에는 체인을 따라가지 않고, table 에서 찾은 Worker 의 WorkImpl_ 만을
+    한 번 호출합니다.
+    체인이 변경되면 (ChangeSuccessor, SoftwareEngineer::Train, Worker 의 소멸 등) Worker 의 generation 이
+    증가하므로, 다음 Work() 호출 시에 table 이 다시 만들어집니다.
+    단, 중간에 처리를 시도했다가 실패하는 Worker 의 부수효과는 생략됩니다.
+*/
+class WorkerDispatchTable
+{
+public:
+    explicit WorkerDispatchTable(Worker& head)
+        : head_(head)
+    {}
+
+    void Work(Task task)
+    {
+        if (generation_ != Worker::GetChainGeneration())
+        {
+            Rebuild_();
+        }
+
+        Worker* handler = table_[static_cast<std::size_t>(task)];
+
+        if (handler)
+        {
+            handler->WorkImpl_(task);
+        }
+        else
+        {
+            std::cout << "Fail to handle task. (" << GetNameOfTask(task) << ")" << std::endl;
+        }
+    }
+
+private:
+    void Rebuild_()
+    {
+        for (std::size_t i = 0; i < kTaskCount; ++i)
+        {
+            table_[i] = Resolve_(static_cast<Task>(i));
+        }
+
+        generation_ = Worker::GetChainGeneration();
+    }
+
+    Worker* Resolve_(Task task) const
+    {
+        for (Worker* worker = &head_; worker; worker = worker->successor_)
+        {
+            if (worker->CanHandle_(task))
+            {
+                return worker;
+            }
+        }
+
+        return nullptr;
+    }
+
+    Worker& head_;
+    std::array<Worker*, kTaskCount> table_{};
+    std::uint64_t generation_{ ~std::uint64_t{ 0 } };
+};
+
+class CustomerSupporter : public Worker
+{
+public:
+    using Worker::Worker;
+
+private:
+    bool CanHandle_(Task task) const override
+    {
+        return task == Task::CustomerIssue;
+    }
+
+    bool WorkImpl_(Task task) override
+    {
+        switch (task)
+        {
+        case Task::CustomerIssue:
+            std::cout << "[CustomerSupporter] Resolve customer issue." << std::endl;
+            return true;
+
+        default:
+            return false;
+        }
+    }
+};
+
+class SoftwareEngineer : public Worker
+{
+public:
+    using Worker::Worker;
+
+    void Train()
+    {
+        isTrained_ = true;
+        InvalidateChains_();
+    }
+
+private:
+    bool CanHandle_(Task task) const override
+    {
+        switch (task)
+        {
+        case Task::Programming:
+            return true;
+
+        case Task::HardProgramming:
+            return isTrained_;
+
+        default:
+            return false;
+        }
+    }
+
+    bool WorkImpl_(Task task) override
+    {
+        switch (task)
+        {
+        case Task::Programming:
+            std::cout << "[SoftwareEngineer] Programming." << std::endl;
+            return true;
+
+        case Task::HardProgramming:
+            if (isTrained_)
+            {
+                std::cout << "[SoftwareEngineer] Successfully solve hard problem!" << std::endl;
+                return true;
+            }
+            else
+            {
+                std::cout << "[SoftwareEngineer] Try to solve hard problem. But failed." << std::endl;
+                return false;
+            }
+
+        default:
+            return false;
+        }
+    }
+
+    bool isTrained_{ false };
+};
+
+class CEO : public Worker
+{
+public:
+    using Worker::Worker;
+
+private:
+    bool CanHandle_(Task task) const override
+    {
+        return task == Task::MoneyIssue || task == Task::M_And_A;
+    }
+
+    bool WorkImpl_(Task task) override
+    {
+        switch (task)
+        {
+        case Task::MoneyIssue:
+            std::cout << "[CEO] Resolve money issue." << std::endl;
+            return true;
+
+        case Task::M_And_A:
+            std::cout << "[CEO] Do M&A." << std::endl;
+            return true;
+
+        default:
+            return false;
+        }
+    }
+};
+
+class God : public Worker
+{
+public:
+    using Worker::Worker;
+
+private:
+    bool CanHandle_(Task) const override
+    {
+        return true;
+    }
+
+    bool WorkImpl_(Task) override
+    {
+        std::cout << "[God] God can do anything!" << std::endl;
+        return true;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Benchmark 용 Worker 들. (출력으로 인한 overhead 를 없애기 위해 아무것도 출력하지 않습니다.)
+
+// 아무 일도 처리하지 못하고 다음 Worker 에게 넘깁니다.
+class Intern : public Worker
+{
+public:
+    using Worker::Worker;
+
+private:
+    bool CanHandle_(Task) const override { return false; }
+    bool WorkImpl_(Task) override { return false; }
+};
+
+// 모든 일을 조용히 처리하고, 처리한 횟수만 기록합니다.
+class Secretary : public Worker
+{
+public:
+    using Worker::Worker;
+
+    std::uint64_t GetHandledCount() const { return handledCount_; }
+
+private:
+    bool CanHandle_(Task) const override { return true; }
+    bool WorkImpl_(Task) override { ++handledCount_; return true; }
+
+    std::uint64_t handledCount_{ 0 };
+};
+
+template <typename Func>
+double MeasureMilliseconds(Func&& func)
+{
+    auto start = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void Benchmark(std::size_t depth, std::size_t taskCount)
+{
+    Secretary secretary(nullptr);
+    std::vector<std::unique_ptr<Intern>> interns;
+    Worker* head = &secretary;
+
+    for (std::size_t i = 1; i < depth; ++i)
+    {
+        interns.push_back(std::make_unique<Intern>(head));
+        head = interns.back().get();
+    }
+
+    WorkerDispatchTable table(*head);
+
+    auto recursiveTime = MeasureMilliseconds([&]
+    {
+        for (std::size_t i = 0; i < taskCount; ++i)
+        {
+            head->Work(static_cast<Task>(i % kTaskCount));
+        }
+    });
+
+    auto tableTime = MeasureMilliseconds([&]
+    {
+        for (std::size_t i = 0; i < taskCount; ++i)
+        {
+            table.Work(static_cast<Task>(i % kTaskCount));
+        }
+    });
+
+    std::cout << "depth " << depth << " : recursive " << recursiveTime << " ms, table "
+        << tableTime << " ms (handled " << secretary.GetHandledCount() << ")" << std::endl;
+}
+
+int main()
+{
+    CEO ceo(nullptr);
+    SoftwareEngineer se(&ceo);
+    CustomerSupporter supporter{ &se };
+    WorkerDispatchTable table(supporter);
+
+    std::cout << "----------------------" << std::endl;
+    table.Work(Task::CustomerIssue);
+    table.Work(Task::Programming);
+    table.Work(Task::HardProgramming);
+
+    std::cout << "Train software engineer!" << std::endl;
+    se.Train();
+    table.Work(Task::HardProgramming);
+    table.Work(Task::MoneyIssue);
+    table.Work(Task::M_And_A);
+    table.Work(Task::ImpossibleTask);
+
+    std::cout << "Change ceo's successor to 'GOD'!" << std::endl;
+    God god(nullptr);
+    ceo.ChangeSuccessor(&god);
+    table.Work(Task::ImpossibleTask);
+
+    std::cout << "---- Benchmark (1,000,000 tasks) ----" << std::endl;
+    Benchmark(4, 1000000);
+    Benchmark(32, 1000000);
+    Benchmark(256, 1000000);
+}
@@ -0,0 +1,543 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum class Task
+{
+    CustomerIssue,
+    Programming,
+    HardProgramming,
+    MoneyIssue,
+    M_And_A,
+    ImpossibleTask
+};
+
+constexpr std::size_t kTaskCount = static_cast<std::size_t>(Task::ImpossibleTask) + 1;
+
+inline std::string GetNameOfTask(Task task)
+{
+    switch (task)
+    {
+    case Task::CustomerIssue:
+        return "CustomerIssue";
+    case Task::Programming:
+        return "Programming";
+    case Task::HardProgramming:
+        return "HardProgramming";
+    case Task::MoneyIssue:
+        return "MoneyIssue";
+    case Task::M_And_A:
+        return "M_And_A";
+    case Task::ImpossibleTask:
+        return "ImpossibleTask";
+    default:
+        throw std::invalid_argument("");
+    }
+}
+
+// 여러 stage thread 에서 출력하므로, 한 줄 단위로 섞이지 않게 출력합니다.
+inline void PrintLine(std::string const& line)
+{
+    static std::mutex mutex;
+    std::lock_guard<std::mutex> lock(mutex);
+    std::cout << line << std::endl;
+}
+
+/*
+    Single-Producer Single-Consumer 고정 크기 queue 입니다.
+    Push 는 한 thread 에서만, Pop 은 다른 한 thread 에서만 호출해야 합니다.
+*/
+template <typename T, std::size_t Capacity>
+class SpscQueue
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two.");
+
+public:
+    bool TryPush(T const& value)
+    {
+        auto tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == Capacity)
+        {
+            return false;
+        }
+
+        buffer_[tail & (Capacity - 1)] = value;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool TryPop(T& value)
+    {
+        auto head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        value = buffer_[head & (Capacity - 1)];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    std::size_t Size() const
+    {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+private:
+    std::array<T, Capacity> buffer_;
+    alignas(64) std::atomic<std::size_t> head_{ 0 };
+    alignas(64) std::atomic<std::size_t> tail_{ 0 };
+};
+
+class Worker
+{
+public:
+    explicit Worker(Worker* successor)
+        : successor_(successor)
+    {}
+
+    virtual ~Worker() = default;
+
+    void Work(Task task)
+    {
+        if (WorkImpl_(task))
+        {
+            return;
+        }
+
+        if (successor_)
+        {
+            successor_->Work(task);
+        }
+        else
+        {
+            PrintLine("Fail to handle task. (" + GetNameOfTask(task) + ")");
+        }
+    }
+
+    Worker* ChangeSuccessor(Worker* successor)
+    {
+        Worker* old = successor_;
+        successor_ = successor;
+        return old;
+    }
+
+private:
+    friend class WorkerPipeline;
+
+    virtual bool WorkImpl_(Task task) = 0;
+
+    Worker* successor_;
+};
+
+/*
+    체인의 각 Worker 를 하나의 stage 로 보고, stage 마다 별도의 thread 에서 실행합니다.
+    각 stage 는 앞 stage 로부터 SPSC queue 로 Task 를 받고, 처리하지 못한 Task 는
+    다음 stage 의 queue 로 넘깁니다. 따라서 앞쪽의 가벼운 Worker 와 뒤쪽의 무거운 Worker 가
+    동시에 서로 다른 Task 를 처리하게 됩니다.
+    다음 stage 의 queue 가 가득 차면 그 stage 는 queue 에 자리가 날 때까지 기다리고,
+    결국 Submit 쪽까지 backpressure 가 전달됩니다.
+    (Worker 에 설정된 successor 는 사용하지 않고, 생성자로 받은 순서대로 stage 를 구성합니다.)
+*/
+class WorkerPipeline
+{
+public:
+    static constexpr std::size_t kQueueCapacity = 1024;
+
+    struct StageMetrics
+    {
+        std::uint64_t processed;
+        std::uint64_t handled;
+        std::uint64_t backpressureStalls;   //< 다음 stage 의 queue 가 가득 차서 기다린 횟수
+        std::size_t queueDepth;             //< 현재 입력 queue 에 쌓인 Task 수
+        std::size_t maxQueueDepth;
+    };
+
+    explicit WorkerPipeline(std::vector<Worker*> workers)
+    {
+        if (workers.empty())
+        {
+            throw std::invalid_argument("Pipeline needs at least one worker.");
+        }
+
+        for (auto* worker : workers)
+        {
+            stages_.push_back(std::make_unique<Stage_>(*worker));
+        }
+
+        std::size_t startedCount = 0;
+        try
+        {
+            for (; startedCount < stages_.size(); ++startedCount)
+            {
+                auto i = startedCount;
+                Stage_* next = (i + 1 < stages_.size()) ? stages_[i + 1].get() : nullptr;
+                stages_[i]->thread = std::thread([this, i, next] { RunStage_(*stages_[i], next); });
+            }
+        }
+        catch (...)
+        {
+            // joinable 한 std::thread 가 소멸되면 std::terminate 되므로, 이미 시작된 stage 들을 종료시키고 join 합니다.
+            stages_.front()->upstreamDone.store(true, std::memory_order_release);
+            for (std::size_t i = 0; i < startedCount; ++i)
+            {
+                stages_[i]->thread.join();
+            }
+            throw;
+        }
+    }
+
+    ~WorkerPipeline()
+    {
+        Close();
+    }
+
+    WorkerPipeline(WorkerPipeline const&) = delete;
+    WorkerPipeline& operator=(WorkerPipeline const&) = delete;
+
+    // 첫 stage 의 queue 가 가득 차 있으면 바로 false 를 반환합니다. (한 thread 에서만 호출해야 합니다.)
+    // Close 된 뒤에는 queue 를 비울 thread 가 없으므로, std::runtime_error 를 던집니다.
+    bool TrySubmit(Task task)
+    {
+        if (closed_)
+        {
+            throw std::runtime_error("Pipeline is already closed.");
+        }
+        return stages_.front()->queue.TryPush(task);
+    }
+
+    // 첫 stage 의 queue 에 자리가 날 때까지 기다립니다. (한 thread 에서만 호출해야 합니다.)
+    // Close 된 뒤에 호출하면 TrySubmit 과 마찬가지로 std::runtime_error 를 던집니다.
+    void Submit(Task task)
+    {
+        while (!TrySubmit(task))
+        {
+            ++submitStalls_;
+            std::this_thread::yield();
+        }
+    }
+
+    // 지금까지 넣은 Task 들을 모두 처리하고, stage thread 들을 종료합니다.
+    void Close()
+    {
+        if (closed_)
+        {
+            return;
+        }
+        closed_ = true;
+
+        stages_.front()->upstreamDone.store(true, std::memory_order_release);
+        for (auto& stage : stages_)
+        {
+            stage->thread.join();
+        }
+    }
+
+    std::vector<StageMetrics> GetMetrics() const
+    {
+        std::vector<StageMetrics> metrics;
+        for (auto const& stage : stages_)
+        {
+            metrics.push_back({
+                stage->processed.load(std::memory_order_relaxed),
+                stage->handled.load(std::memory_order_relaxed),
+                stage->backpressureStalls.load(std::memory_order_relaxed),
+                stage->queue.Size(),
+                stage->maxQueueDepth.load(std::memory_order_relaxed) });
+        }
+        return metrics;
+    }
+
+    std::uint64_t GetSubmitStalls() const { return submitStalls_; }
+    std::uint64_t GetFailedCount() const { return failed_.load(std::memory_order_relaxed); }
+
+private:
+    struct Stage_
+    {
+        explicit Stage_(Worker& worker) : worker(worker) {}
+
+        Worker& worker;
+        SpscQueue<Task, kQueueCapacity> queue;
+        std::atomic<bool> upstreamDone{ false };
+        std::thread thread;
+
+        std::atomic<std::uint64_t> processed{ 0 };
+        std::atomic<std::uint64_t> handled{ 0 };
+        std::atomic<std::uint64_t> backpressureStalls{ 0 };
+        std::atomic<std::size_t> maxQueueDepth{ 0 };
+    };
+
+    void RunStage_(Stage_& stage, Stage_* next)
+    {
+        Task task;
+
+        while (true)
+        {
+            if (!stage.queue.TryPop(task))
+            {
+                if (!stage.upstreamDone.load(std::memory_order_acquire))
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                // upstreamDone 을 본 뒤에 한 번 더 확인해야, 그 직전에 넣어진 Task 를 놓치지 않습니다.
+                if (!stage.queue.TryPop(task))
+                {
+                    break;
+                }
+            }
+
+            // 통계는 이 stage thread 만 쓰므로, relaxed 로 충분합니다.
+            auto depth = stage.queue.Size() + 1;
+            if (depth > stage.maxQueueDepth.load(std::memory_order_relaxed))
+            {
+                stage.maxQueueDepth.store(depth, std::memory_order_relaxed);
+            }
+            stage.processed.store(stage.processed.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+            if (stage.worker.WorkImpl_(task))
+            {
+                stage.handled.store(stage.handled.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            }
+            else if (next)
+            {
+                while (!next->queue.TryPush(task))
+                {
+                    stage.backpressureStalls.store(
+                        stage.backpressureStalls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                    std::this_thread::yield();
+                }
+            }
+            else
+            {
+                failed_.fetch_add(1, std::memory_order_relaxed);
+                PrintLine("Fail to handle task. (" + GetNameOfTask(task) + ")");
+            }
+        }
+
+        if (next)
+        {
+            next->upstreamDone.store(true, std::memory_order_release);
+        }
+    }
+
+    std::vector<std::unique_ptr<Stage_>> stages_;
+    std::uint64_t submitStalls_{ 0 };
+    std::atomic<std::uint64_t> failed_{ 0 };
+    bool closed_{ false };
+};
+
+class CustomerSupporter : public Worker
+{
+public:
+    using Worker::Worker;
+
+private:
+    bool WorkImpl_(Task task) override
+    {
+        switch (task)
+        {
+        case Task::CustomerIssue:
+            PrintLine("[CustomerSupporter] Resolve customer issue.");
+            return true;
+
+        default:
+            return false;
+        }
+    }
+};
+
+class SoftwareEngineer : public Worker
+{
+public:
+    using Worker::Worker;
+
+    void Train()
+    {
+        isTrained_.store(true);
+    }
+
+private:
+    bool WorkImpl_(Task task) override
+    {
+        switch (task)
+        {
+        case Task::Programming:
+            PrintLine("[SoftwareEngineer] Programming.");
+            return true;
+
+        case Task::HardProgramming:
+            if (isTrained_.load())
+            {
+                PrintLine("[SoftwareEngineer] Successfully solve hard problem!");
+                return true;
+            }
+            else
+            {
+                PrintLine("[SoftwareEngineer] Try to solve hard problem. But failed.");
+                return false;
+            }
+
+        default:
+            return false;
+        }
+    }
+
+    std::atomic<bool> isTrained_{ false };
+};
+
+class CEO : public Worker
+{
+public:
+    using Worker::Worker;
+
+private:
+    bool WorkImpl_(Task task) override
+    {
+        switch (task)
+        {
+        case Task::MoneyIssue:
+            PrintLine("[CEO] Resolve money issue.");
+            return true;
+
+        case Task::M_And_A:
+            PrintLine("[CEO] Do M&A.");
+            return true;
+
+        default:
+            return false;
+        }
+    }
+};
+
+class God : public Worker
+{
+public:
+    using Worker::Worker;
+
+private:
+    bool WorkImpl_(Task) override
+    {
+        PrintLine("[God] God can do anything!");
+        return true;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Benchmark 용 Worker. (아무것도 출력하지 않고, 정해진 시간만큼 일을 합니다.)
+
+class BusyWorker : public Worker
+{
+public:
+    BusyWorker(Worker* successor, Task handledTask, std::chrono::microseconds cost)
+        : Worker(successor), handledTask_(handledTask), cost_(cost)
+    {}
+
+private:
+    bool WorkImpl_(Task task) override
+    {
+        auto until = std::chrono::steady_clock::now() + cost_;
+        while (std::chrono::steady_clock::now() < until)
+        {}
+
+        return task == handledTask_ || handledTask_ == Task::ImpossibleTask;
+    }
+
+    Task handledTask_;
+    std::chrono::microseconds cost_;
+};
+
+void PrintMetrics(WorkerPipeline const& pipeline, std::vector<std::string> const& names)
+{
+    auto metrics = pipeline.GetMetrics();
+    for (std::size_t i = 0; i < metrics.size(); ++i)
+    {
+        std::cout << "  " << names[i] << " : processed " << metrics[i].processed
+            << ", handled " << metrics[i].handled
+            << ", stalls " << metrics[i].backpressureStalls
+            << ", queue " << metrics[i].queueDepth << " (max " << metrics[i].maxQueueDepth << ")" << std::endl;
+    }
+    std::cout << "  submit stalls " << pipeline.GetSubmitStalls()
+        << ", failed " << pipeline.GetFailedCount() << std::endl;
+}
+
+void Benchmark(std::size_t taskCount)
+{
+    using namespace std::chrono_literals;
+
+    // 앞쪽 Worker 는 가볍고, 뒤쪽 Worker 는 무겁습니다.
+    BusyWorker back(nullptr, Task::ImpossibleTask, 20us);
+    BusyWorker middle(&back, Task::Programming, 10us);
+    BusyWorker front(&middle, Task::CustomerIssue, 1us);
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < taskCount; ++i)
+    {
+        front.Work(static_cast<Task>(i % kTaskCount));
+    }
+    auto serialTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    WorkerPipeline pipeline({ &front, &middle, &back });
+    start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < taskCount; ++i)
+    {
+        pipeline.Submit(static_cast<Task>(i % kTaskCount));
+    }
+    pipeline.Close();
+    auto pipelineTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "serial : " << serialTime << " ms, pipeline : " << pipelineTime << " ms" << std::endl;
+    PrintMetrics(pipeline, { "front ", "middle", "back  " });
+}
+
+int main()
+{
+    CEO ceo(nullptr);
+    SoftwareEngineer se(nullptr);
+    CustomerSupporter supporter{ nullptr };
+    God god(nullptr);
+
+    std::cout << "----------------------" << std::endl;
+    {
+        WorkerPipeline pipeline({ &supporter, &se, &ceo });
+        for (auto task : { Task::CustomerIssue, Task::Programming, Task::HardProgramming,
+                           Task::MoneyIssue, Task::M_And_A, Task::ImpossibleTask })
+        {
+            pipeline.Submit(task);
+        }
+        pipeline.Close();
+        PrintMetrics(pipeline, { "CustomerSupporter", "SoftwareEngineer ", "CEO              " });
+
+        try
+        {
+            pipeline.Submit(Task::CustomerIssue);
+        }
+        catch (std::runtime_error const& e)
+        {
+            std::cout << "Submit after close : " << e.what() << std::endl;
+        }
+    }
+
+    std::cout << "Train software engineer, and add 'GOD' at the end!" << std::endl;
+    se.Train();
+    {
+        WorkerPipeline pipeline({ &supporter, &se, &ceo, &god });
+        pipeline.Submit(Task::HardProgramming);
+        pipeline.Submit(Task::ImpossibleTask);
+    }
+
+    std::cout << "---- Benchmark (3000 tasks) ----" << std::endl;
+    Benchmark(3000);
+}
@@ -0,0 +1,377 @@
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(_MSC_VER)
+#define NOINLINE __declspec(noinline)
+#else
+#define NOINLINE __attribute__((noinline))
+#endif
+
+enum class Task
+{
+    CustomerIssue,
+    Programming,
+    HardProgramming,
+    MoneyIssue,
+    M_And_A,
+    ImpossibleTask
+};
+
+constexpr std::size_t kTaskCount = static_cast<std::size_t>(Task::ImpossibleTask) + 1;
+
+inline std::string GetNameOfTask(Task task)
+{
+    switch (task)
+    {
+    case Task::CustomerIssue:
+        return "CustomerIssue";
+    case Task::Programming:
+        return "Programming";
+    case Task::HardProgramming:
+        return "HardProgramming";
+    case Task::MoneyIssue:
+        return "MoneyIssue";
+    case Task::M_And_A:
+        return "M_And_A";
+    case Task::ImpossibleTask:
+        return "ImpossibleTask";
+    default:
+        throw std::invalid_argument("");
+    }
+}
+
+// 체인 본문에 iostream 코드가 inline 되지 않도록, 실패 메시지 출력은 분리해둡니다.
+NOINLINE void PrintFailure(Task task)
+{
+    std::cout << "Fail to handle task. (" << GetNameOfTask(task) << ")" << std::endl;
+}
+
+/*
+    체인의 구성을 런타임에 바꿀 필요가 없는 경우, 가변 인자 템플릿으로 체인을 정적으로
+    구성할 수 있습니다.
+    각 Worker 의 Work 는 가상 함수가 아니므로, 컴파일러가 체인 전체를 inline 하여
+    Task 에 대한 하나의 분기문으로 만들 수 있습니다.
+    비록 ChangeSuccessor 와 같이 체인을 바꾸는 것은 불가능하지만, 가상 함수 호출과
+    successor 를 따라가는 overhead 가 없습니다.
+*/
+template <typename... Workers>
+class StaticChain
+{
+public:
+    StaticChain() = default;
+
+    explicit StaticChain(Workers... workers)
+        : workers_(std::move(workers)...)
+    {}
+
+    bool Work(Task task)
+    {
+        if (WorkImpl_(task, std::integral_constant<std::size_t, 0>()))
+        {
+            return true;
+        }
+
+        PrintFailure(task);
+        return false;
+    }
+
+    template <typename Worker>
+    Worker& Get()
+    {
+        return std::get<Worker>(workers_);
+    }
+
+private:
+    template <std::size_t Index>
+    bool WorkImpl_(Task task, std::integral_constant<std::size_t, Index>)
+    {
+        return std::get<Index>(workers_).Work(task)
+            || WorkImpl_(task, std::integral_constant<std::size_t, Index + 1>());
+    }
+
+    bool WorkImpl_(Task, std::integral_constant<std::size_t, sizeof...(Workers)>)
+    {
+        return false;
+    }
+
+    std::tuple<Workers...> workers_;
+};
+
+class CustomerSupporter
+{
+public:
+    bool Work(Task task)
+    {
+        switch (task)
+        {
+        case Task::CustomerIssue:
+            std::cout << "[CustomerSupporter] Resolve customer issue." << std::endl;
+            return true;
+
+        default:
+            return false;
+        }
+    }
+};
+
+class SoftwareEngineer
+{
+public:
+    void Train()
+    {
+        isTrained_ = true;
+    }
+
+    bool Work(Task task)
+    {
+        switch (task)
+        {
+        case Task::Programming:
+            std::cout << "[SoftwareEngineer] Programming." << std::endl;
+            return true;
+
+        case Task::HardProgramming:
+            if (isTrained_)
+            {
+                std::cout << "[SoftwareEngineer] Successfully solve hard problem!" << std::endl;
+                return true;
+            }
+            else
+            {
+                std::cout << "[SoftwareEngineer] Try to solve hard problem. But failed." << std::endl;
+                return false;
+            }
+
+        default:
+            return false;
+        }
+    }
+
+private:
+    bool isTrained_{ false };
+};
+
+class CEO
+{
+public:
+    bool Work(Task task)
+    {
+        switch (task)
+        {
+        case Task::MoneyIssue:
+            std::cout << "[CEO] Resolve money issue." << std::endl;
+            return true;
+
+        case Task::M_And_A:
+            std::cout << "[CEO] Do M&A." << std::endl;
+            return true;
+
+        default:
+            return false;
+        }
+    }
+};
+
+class God
+{
+public:
+    bool Work(Task)
+    {
+        std::cout << "[God] God can do anything!" << std::endl;
+        return true;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Benchmark 에서 비교할 동적 체인과 미리 계산된 jump table. (worker_dispatch_table.cpp 참고)
+
+class DynamicWorker
+{
+public:
+    explicit DynamicWorker(DynamicWorker* successor)
+        : successor_(successor)
+    {}
+
+    virtual ~DynamicWorker() = default;
+
+    bool Work(Task task)
+    {
+        if (WorkImpl_(task))
+        {
+            return true;
+        }
+
+        return successor_ ? successor_->Work(task) : false;
+    }
+
+private:
+    friend class DynamicDispatchTable;
+
+    virtual bool CanHandle_(Task task) const = 0;
+    virtual bool WorkImpl_(Task task) = 0;
+
+    DynamicWorker* successor_;
+};
+
+class DynamicDispatchTable
+{
+public:
+    explicit DynamicDispatchTable(DynamicWorker& head)
+    {
+        for (std::size_t i = 0; i < kTaskCount; ++i)
+        {
+            for (DynamicWorker* worker = &head; worker; worker = worker->successor_)
+            {
+                if (worker->CanHandle_(static_cast<Task>(i)))
+                {
+                    table_[i] = worker;
+                    break;
+                }
+            }
+        }
+    }
+
+    bool Work(Task task)
+    {
+        DynamicWorker* handler = table_[static_cast<std::size_t>(task)];
+        return handler ? handler->WorkImpl_(task) : false;
+    }
+
+private:
+    std::array<DynamicWorker*, kTaskCount> table_{};
+};
+
+// 한 종류의 Task 만 조용히 처리하고, 처리한 횟수를 기록합니다.
+template <Task HandledTask>
+class Specialist
+{
+public:
+    bool Work(Task task)
+    {
+        if (task != HandledTask)
+        {
+            return false;
+        }
+        ++handledCount_;
+        return true;
+    }
+
+    std::uint64_t GetHandledCount() const { return handledCount_; }
+
+private:
+    std::uint64_t handledCount_{ 0 };
+};
+
+template <Task HandledTask>
+class DynamicSpecialist : public DynamicWorker
+{
+public:
+    using DynamicWorker::DynamicWorker;
+
+    std::uint64_t GetHandledCount() const { return specialist_.GetHandledCount(); }
+
+private:
+    bool CanHandle_(Task task) const override { return task == HandledTask; }
+    bool WorkImpl_(Task task) override { return specialist_.Work(task); }
+
+    Specialist<HandledTask> specialist_;
+};
+
+using BenchmarkChain = StaticChain<
+    Specialist<Task::CustomerIssue>,
+    Specialist<Task::Programming>,
+    Specialist<Task::HardProgramming>,
+    Specialist<Task::MoneyIssue>,
+    Specialist<Task::M_And_A>>;
+
+/*
+    생성된 어셈블리에 간접 호출이 없는지 확인하기 위한 함수입니다.
+        g++ -std=c++14 -O2 -S worker_static.cpp -o - | c++filt
+    의 결과에서, 이 함수의 본문에 'call *' 또는 'callq *' 형태의 명령이 없어야 합니다.
+    (ImpossibleTask 의 실패 메시지 출력을 위한 PrintFailure 직접 호출만 남습니다.)
+*/
+NOINLINE bool RunStaticChainForAssemblyCheck(BenchmarkChain& chain, Task task)
+{
+    return chain.Work(task);
+}
+
+template <typename Func>
+double MeasureMilliseconds(Func&& func)
+{
+    auto start = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void Benchmark(std::size_t taskCount)
+{
+    // ImpossibleTask 를 제외한 Task 들만 사용하여, 실패 메시지 출력이 측정에 섞이지 않도록 합니다.
+    constexpr std::size_t kHandledTaskCount = kTaskCount - 1;
+
+    DynamicSpecialist<Task::M_And_A> ma(nullptr);
+    DynamicSpecialist<Task::MoneyIssue> money(&ma);
+    DynamicSpecialist<Task::HardProgramming> hard(&money);
+    DynamicSpecialist<Task::Programming> programming(&hard);
+    DynamicSpecialist<Task::CustomerIssue> customer(&programming);
+    DynamicDispatchTable table(customer);
+    BenchmarkChain chain;
+
+    std::uint64_t handled = 0;
+
+    auto dynamicTime = MeasureMilliseconds([&]
+    {
+        for (std::size_t i = 0; i < taskCount; ++i)
+            handled += customer.Work(static_cast<Task>(i % kHandledTaskCount));
+    });
+
+    auto tableTime = MeasureMilliseconds([&]
+    {
+        for (std::size_t i = 0; i < taskCount; ++i)
+            handled += table.Work(static_cast<Task>(i % kHandledTaskCount));
+    });
+
+    auto staticTime = MeasureMilliseconds([&]
+    {
+        for (std::size_t i = 0; i < taskCount; ++i)
+            handled += RunStaticChainForAssemblyCheck(chain, static_cast<Task>(i % kHandledTaskCount));
+    });
+
+    std::cout << "dynamic chain : " << dynamicTime << " ms" << std::endl;
+    std::cout << "jump table    : " << tableTime << " ms" << std::endl;
+    std::cout << "static chain  : " << staticTime << " ms" << std::endl;
+    std::cout << "(handled " << handled << ")" << std::endl;
+}
+
+int main()
+{
+    StaticChain<CustomerSupporter, SoftwareEngineer, CEO> chain;
+
+    std::cout << "----------------------" << std::endl;
+    chain.Work(Task::CustomerIssue);
+    chain.Work(Task::Programming);
+    chain.Work(Task::HardProgramming);
+
+    std::cout << "Train software engineer!" << std::endl;
+    chain.Get<SoftwareEngineer>().Train();
+    chain.Work(Task::HardProgramming);
+    chain.Work(Task::MoneyIssue);
+    chain.Work(Task::M_And_A);
+    chain.Work(Task::ImpossibleTask);
+
+    // 정적 체인에서는 successor 를 바꿀 수 없으므로, 새로운 체인을 만듭니다.
+    std::cout << "Make a new chain which ends with 'GOD'!" << std::endl;
+    StaticChain<CustomerSupporter, SoftwareEngineer, CEO, God> chainWithGod;
+    chainWithGod.Work(Task::ImpossibleTask);
+
+    std::cout << "---- Benchmark (10,000,000 tasks) ----" << std::endl;
+    Benchmark(10000000);
+}
@@ -0,0 +1,544 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* Receiver (실제 요청을 처리할 책임을 지는 객체) */
+class WebPageManager
+{
+public:
+    explicit WebPageManager(std::string name)
+        : name_(std::move(name))
+    {}
+
+    // 같은 WebPageManager 에 대한 호출은 항상 한 thread 에서 순서대로 일어나야 합니다.
+    void ChangeWebPage(std::string const& webPage)
+    {
+        history_.push_back(webPage);
+    }
+
+    std::string const& GetName() const { return name_; }
+    std::vector<std::string> const& GetHistory() const { return history_; }
+
+private:
+    std::string name_;
+    std::vector<std::string> history_;
+};
+
+class Command
+{
+public:
+    virtual ~Command() = default;
+
+    virtual void Execute() = 0;
+
+    /*
+        같은 affinity key 를 가진 Command 들은 항상 같은 thread 에서, 들어온 순서대로
+        실행됩니다. nullptr 이면 아무 thread 에서나 실행될 수 있습니다.
+    */
+    virtual void const* GetAffinityKey() const
+    {
+        return nullptr;
+    }
+};
+
+class ChangeWebPageCommand : public Command
+{
+public:
+    ChangeWebPageCommand(WebPageManager& pageManager, std::string webPage)
+        : pageManager_(pageManager), webPage_(std::move(webPage))
+    {}
+
+    void Execute() override
+    {
+        pageManager_.ChangeWebPage(webPage_);
+    }
+
+    void const* GetAffinityKey() const override
+    {
+        return &pageManager_;
+    }
+
+private:
+    WebPageManager& pageManager_;
+    std::string webPage_;
+};
+
+/* 템플릿을 활용해서, 임의의 Receiver에게 명령을 전달할 수 있도록 한다. */
+template <typename Receiver>
+class GenericCommand : public Command
+{
+public:
+    explicit GenericCommand(Receiver&& receiver)
+        : receiver_(std::move(receiver))
+    {}
+
+    void Execute() override
+    {
+        receiver_();
+    }
+
+private:
+    Receiver receiver_;
+};
+
+template <typename Receiver>
+auto MakeGenericCommand(Receiver&& receiver)
+    -> GenericCommand<Receiver>
+{
+    return GenericCommand<Receiver>(std::move(receiver));
+}
+
+/*
+    여러 Command 의 완료를 한꺼번에 기다리기 위해 사용합니다.
+    Wait 가 돌아오면 executor 는 더 이상 이 객체를 건드리지 않으므로, 바로 없애도 됩니다.
+*/
+class CommandBatch
+{
+public:
+    void Wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return remaining_.load() == 0; });
+    }
+
+private:
+    friend class CommandExecutor;
+    friend class NaiveCommandExecutor;
+
+    void Add_()
+    {
+        remaining_.fetch_add(1);
+    }
+
+    void Done_()
+    {
+        // 0 이 되지 않는 감소는 lock 없이 합니다.
+        auto remaining = remaining_.load();
+        while (remaining > 1)
+        {
+            if (remaining_.compare_exchange_weak(remaining, remaining - 1))
+            {
+                return;
+            }
+        }
+
+        // 0 으로 만드는 감소와 통지는 lock 안에서 합니다. 그래야 Wait 가 0 을 보고 돌아와서
+        // 이 객체를 없앤 뒤에, 이 thread 가 mutex_ 나 cv_ 를 건드리는 일이 없습니다.
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (remaining_.fetch_sub(1) == 1)
+        {
+            cv_.notify_all();
+        }
+    }
+
+    std::atomic<std::size_t> remaining_{ 0 };
+    std::mutex mutex_;
+    std::condition_variable cv_;
+};
+
+/*
+    thread 마다 자신의 deque 를 가지고, 자신의 deque 가 비면 다른 thread 의 deque 에서
+    Command 를 훔쳐와서 실행합니다. (work stealing)
+    하나의 queue 를 모든 thread 가 공유하지 않으므로, thread 수가 늘어도 경합이 적습니다.
+    - 소유 thread 는 deque 의 뒤에서 꺼내고, 다른 thread 는 앞에서 훔쳐갑니다.
+    - affinity key 가 있는 Command 는 key 로 정해진 thread 의 pinned queue 에 들어가고,
+      훔쳐가지 않으므로 들어온 순서대로 한 thread 에서 실행됩니다.
+    Command 객체의 소유권은 가지지 않으므로, 실행될 때까지 살아있어야 합니다.
+*/
+class CommandExecutor
+{
+public:
+    explicit CommandExecutor(std::size_t threadCount)
+    {
+        threadCount = std::max<std::size_t>(threadCount, 1);
+
+        for (std::size_t i = 0; i < threadCount; ++i)
+        {
+            queues_.push_back(std::make_unique<WorkerQueue_>());
+        }
+        for (std::size_t i = 0; i < threadCount; ++i)
+        {
+            threads_.emplace_back([this, i] { Run_(i); });
+        }
+    }
+
+    // 남아있는 Command 들을 모두 실행한 뒤에 종료합니다.
+    ~CommandExecutor()
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            stop_.store(true);
+        }
+        sleepCv_.notify_all();
+
+        for (auto& thread : threads_)
+        {
+            thread.join();
+        }
+    }
+
+    CommandExecutor(CommandExecutor const&) = delete;
+    CommandExecutor& operator=(CommandExecutor const&) = delete;
+
+    // 어느 thread 에서나 호출할 수 있습니다.
+    void Submit(Command& command, CommandBatch* batch = nullptr)
+    {
+        if (batch)
+        {
+            batch->Add_();
+        }
+
+        Item_ item{ &command, batch };
+
+        if (auto key = command.GetAffinityKey())
+        {
+            auto& queue = *queues_[std::hash<void const*>()(key) % queues_.size()];
+            {
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                queue.pinned.push_back(item);
+            }
+            queue.pinnedCount.fetch_add(1);
+            WakeUp_(true);
+        }
+        else
+        {
+            auto& queue = *queues_[currentExecutor_ == this ? currentIndex_ : nextQueue_++ % queues_.size()];
+            {
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                queue.stealable.push_back(item);
+            }
+            stealableCount_.fetch_add(1);
+            WakeUp_(false);
+        }
+    }
+
+    std::size_t GetThreadCount() const { return threads_.size(); }
+
+private:
+    struct Item_
+    {
+        Command* command;
+        CommandBatch* batch;
+    };
+
+    struct alignas(64) WorkerQueue_
+    {
+        std::mutex mutex;
+        std::deque<Item_> stealable;
+        std::deque<Item_> pinned;
+        std::atomic<std::size_t> pinnedCount{ 0 };
+    };
+
+    void WakeUp_(bool isPinned)
+    {
+        if (sleeperCount_.load() == 0)
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        // pinned Command 는 정해진 thread 만 실행할 수 있으므로, 모두 깨웁니다.
+        if (isPinned)
+            sleepCv_.notify_all();
+        else
+            sleepCv_.notify_one();
+    }
+
+    bool TryTake_(std::size_t index, Item_& item)
+    {
+        auto& own = *queues_[index];
+        {
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.pinned.empty())
+            {
+                item = own.pinned.front();
+                own.pinned.pop_front();
+                own.pinnedCount.fetch_sub(1);
+                return true;
+            }
+            if (!own.stealable.empty())
+            {
+                item = own.stealable.back();
+                own.stealable.pop_back();
+                stealableCount_.fetch_sub(1);
+                return true;
+            }
+        }
+
+        for (std::size_t i = 1; i < queues_.size(); ++i)
+        {
+            auto& victim = *queues_[(index + i) % queues_.size()];
+            std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+            if (lock.owns_lock() && !victim.stealable.empty())
+            {
+                item = victim.stealable.front();
+                victim.stealable.pop_front();
+                stealableCount_.fetch_sub(1);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void Run_(std::size_t index)
+    {
+        currentExecutor_ = this;
+        currentIndex_ = index;
+
+        auto& own = *queues_[index];
+        Item_ item;
+
+        while (true)
+        {
+            if (TryTake_(index, item))
+            {
+                item.command->Execute();
+                if (item.batch)
+                {
+                    item.batch->Done_();
+                }
+                continue;
+            }
+
+            // 훔쳐올 수 있는 Command 가 남아있다면 (try_lock 에 실패했을 수 있으므로) 다시 시도합니다.
+            if (stealableCount_.load() > 0)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+            sleeperCount_.fetch_add(1);
+            sleepCv_.wait(lock, [&]
+            {
+                return stealableCount_.load() > 0 || own.pinnedCount.load() > 0 || stop_.load();
+            });
+            sleeperCount_.fetch_sub(1);
+
+            if (stop_.load() && stealableCount_.load() == 0 && own.pinnedCount.load() == 0)
+            {
+                break;
+            }
+        }
+
+        currentExecutor_ = nullptr;
+    }
+
+    std::vector<std::unique_ptr<WorkerQueue_>> queues_;
+    std::vector<std::thread> threads_;
+
+    std::atomic<std::size_t> stealableCount_{ 0 };
+    std::atomic<std::size_t> nextQueue_{ 0 };
+
+    std::mutex sleepMutex_;
+    std::condition_variable sleepCv_;
+    std::atomic<std::size_t> sleeperCount_{ 0 };
+    std::atomic<bool> stop_{ false };
+
+    static thread_local CommandExecutor* currentExecutor_;
+    static thread_local std::size_t currentIndex_;
+};
+
+thread_local CommandExecutor* CommandExecutor::currentExecutor_{ nullptr };
+thread_local std::size_t CommandExecutor::currentIndex_{ 0 };
+
+////////////////////////////////////////////////////////////////////////////////
+// Benchmark : 하나의 mutex 로 보호되는 queue 를 모든 thread 가 공유하는 naive 한 구현과 비교합니다.
+
+class NaiveCommandExecutor
+{
+public:
+    explicit NaiveCommandExecutor(std::size_t threadCount)
+    {
+        for (std::size_t i = 0; i < std::max<std::size_t>(threadCount, 1); ++i)
+        {
+            threads_.emplace_back([this] { Run_(); });
+        }
+    }
+
+    ~NaiveCommandExecutor()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for (auto& thread : threads_)
+        {
+            thread.join();
+        }
+    }
+
+    void Submit(Command& command, CommandBatch* batch)
+    {
+        batch->Add_();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push_back({ &command, batch });
+        }
+        cv_.notify_one();
+    }
+
+private:
+    void Run_()
+    {
+        while (true)
+        {
+            std::pair<Command*, CommandBatch*> item;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return !queue_.empty() || stop_; });
+                if (queue_.empty())
+                {
+                    return;
+                }
+                item = queue_.front();
+                queue_.pop_front();
+            }
+            item.first->Execute();
+            item.second->Done_();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::pair<Command*, CommandBatch*>> queue_;
+    std::vector<std::thread> threads_;
+    bool stop_{ false };
+};
+
+// 약간의 계산을 하는 Command. (여러 thread 에서 동시에 실행되어도 됩니다.)
+class ComputeCommand : public Command
+{
+public:
+    void Execute() override
+    {
+        thread_local std::uint64_t seed = 0;
+        std::uint64_t value = ++seed;
+        for (int i = 0; i < 1000; ++i)
+        {
+            value = value * 6364136223846793005ULL + 1442695040888963407ULL;
+        }
+        sink_.store(value, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<std::uint64_t> sink_{ 0 };
+};
+
+template <typename Executor>
+double MeasureThroughput(std::size_t threadCount, std::size_t commandCount)
+{
+    std::vector<ComputeCommand> commands(64);
+    auto start = std::chrono::steady_clock::now();
+    {
+        Executor executor(threadCount);
+        CommandBatch batch;
+
+        // 여러 thread 에서 동시에 Submit 합니다.
+        std::vector<std::thread> submitters;
+        for (std::size_t s = 0; s < threadCount; ++s)
+        {
+            submitters.emplace_back([&, s]
+            {
+                for (std::size_t i = s; i < commandCount; i += threadCount)
+                {
+                    executor.Submit(commands[i % commands.size()], &batch);
+                }
+            });
+        }
+        for (auto& submitter : submitters)
+        {
+            submitter.join();
+        }
+        batch.Wait();
+    }
+    auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return commandCount / seconds;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Stress Test : Wait 가 돌아오자마자 CommandBatch 를 없애는 것을 반복합니다.
+//               (executor 가 그 뒤에 batch 를 건드린다면 ASan / TSan 이 잡아냅니다.)
+
+bool RunBatchLifetimeTest(std::size_t iterationCount)
+{
+    std::atomic<std::uint64_t> executed{ 0 };
+    auto command = MakeGenericCommand([&executed]() { ++executed; });
+
+    CommandExecutor executor(4);
+    for (std::size_t i = 0; i < iterationCount; ++i)
+    {
+        auto batch = std::make_unique<CommandBatch>();
+        for (std::size_t n = 0; n < 1 + i % 4; ++n)
+        {
+            executor.Submit(command, batch.get());
+        }
+        batch->Wait();
+    }
+
+    std::uint64_t expected = 0;
+    for (std::size_t i = 0; i < iterationCount; ++i)
+    {
+        expected += 1 + i % 4;
+    }
+    return executed == expected;
+}
+
+int main()
+{
+    WebPageManager manager_1("Manager_1"), manager_2("Manager_2");
+    std::vector<std::unique_ptr<Command>> commands;
+    for (int i = 0; i < 5; ++i)
+    {
+        commands.push_back(std::make_unique<ChangeWebPageCommand>(manager_1, "http://taeguk.me/" + std::to_string(i)));
+        commands.push_back(std::make_unique<ChangeWebPageCommand>(manager_2, "http://github.com/" + std::to_string(i)));
+    }
+
+    std::atomic<int> genericCount{ 0 };
+    auto genericCommand = MakeGenericCommand([&genericCount]() { ++genericCount; });
+
+    {
+        CommandExecutor executor(4);
+        CommandBatch batch;
+        for (auto& command : commands)
+        {
+            executor.Submit(*command, &batch);
+            executor.Submit(genericCommand, &batch);
+        }
+        batch.Wait();
+    }
+
+    for (auto* manager : { &manager_1, &manager_2 })
+    {
+        std::cout << manager->GetName() << " :";
+        for (auto const& webPage : manager->GetHistory())
+        {
+            std::cout << " " << webPage;
+        }
+        std::cout << std::endl;
+    }
+    std::cout << "Generic command was executed " << genericCount << " times." << std::endl;
+    std::cout << "Batch lifetime test : " << (RunBatchLifetimeTest(100000) ? "passed" : "FAILED") << std::endl;
+
+    std::size_t maxThreads = std::max(4u, std::thread::hardware_concurrency());
+    std::cout << "---- Benchmark (1,000,000 commands) ----" << std::endl;
+    for (std::size_t threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        std::cout << threads << " threads : work stealing "
+            << MeasureThroughput<CommandExecutor>(threads, 1000000) << " commands/s, single queue "
+            << MeasureThroughput<NaiveCommandExecutor>(threads, 1000000) << " commands/s" << std::endl;
+    }
+}
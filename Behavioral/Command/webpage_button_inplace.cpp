@@ -0,0 +1,309 @@
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/* Receiver (실제 요청을 처리할 책임을 지는 객체) */
+class WebPageManager
+{
+public:
+    void ChangeWebPage(std::string const& webPage)
+    {
+        std::cout << "Change web page to " << webPage << "." << std::endl;
+    }
+
+    void Refresh()
+    {
+        std::cout << "Refresh web page." << std::endl;
+    }
+};
+
+/*
+    가상 함수 대신 함수 포인터 테이블을 직접 만들어서, 임의의 명령 객체를 값으로 담는
+    Command 입니다.
+    명령 객체는 Size 바이트의 내부 버퍼에 그대로 저장되므로, heap 할당이 일어나지 않고,
+    Execute 시에도 vtable 을 한 번만 거치게 됩니다.
+    operator() 를 가진 객체 (lambda 등) 와 Execute() 를 가진 객체 (ChangeWebPageCommand 등)
+    를 모두 담을 수 있습니다.
+*/
+template <std::size_t Size>
+class InplaceCommand
+{
+public:
+    InplaceCommand() = default;
+
+    template <typename Receiver,
+              typename = std::enable_if_t<!std::is_same<std::decay_t<Receiver>, InplaceCommand>::value>>
+    InplaceCommand(Receiver&& receiver)
+    {
+        using Stored = std::decay_t<Receiver>;
+
+        static_assert(sizeof(Stored) <= Size, "Command is too big for the inplace buffer.");
+        static_assert(alignof(Stored) <= alignof(std::max_align_t), "Command is over-aligned.");
+        static_assert(std::is_nothrow_move_constructible<Stored>::value, "Command must be nothrow movable.");
+
+        new (&storage_) Stored(std::forward<Receiver>(receiver));
+        vtable_ = &VTableFor_<Stored>::value;
+    }
+
+    InplaceCommand(InplaceCommand&& other) noexcept
+    {
+        MoveFrom_(other);
+    }
+
+    InplaceCommand& operator=(InplaceCommand&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Reset();
+            MoveFrom_(other);
+        }
+        return *this;
+    }
+
+    InplaceCommand(InplaceCommand const&) = delete;
+    InplaceCommand& operator=(InplaceCommand const&) = delete;
+
+    ~InplaceCommand()
+    {
+        Reset();
+    }
+
+    void Execute()
+    {
+        if (vtable_)
+        {
+            vtable_->execute(&storage_);
+        }
+    }
+
+    void Reset()
+    {
+        if (vtable_)
+        {
+            vtable_->destroy(&storage_);
+            vtable_ = nullptr;
+        }
+    }
+
+    explicit operator bool() const { return vtable_ != nullptr; }
+
+private:
+    struct VTable_
+    {
+        void (*execute)(void* object);
+        void (*destroy)(void* object);
+        void (*move)(void* dest, void* src);   //< src 로부터 dest 를 생성하고, src 를 파괴합니다.
+    };
+
+    template <typename Stored>
+    struct VTableFor_
+    {
+        static void Execute(void* object) { Invoke_(*static_cast<Stored*>(object), 0); }
+        static void Destroy(void* object) { static_cast<Stored*>(object)->~Stored(); }
+        static void Move(void* dest, void* src)
+        {
+            new (dest) Stored(std::move(*static_cast<Stored*>(src)));
+            Destroy(src);
+        }
+
+        static constexpr VTable_ value{ &Execute, &Destroy, &Move };
+    };
+
+    // Execute() 를 가진 객체는 Execute() 를, 그렇지 않으면 operator() 를 호출합니다.
+    template <typename Stored>
+    static auto Invoke_(Stored& object, int) -> decltype(object.Execute(), void())
+    {
+        object.Execute();
+    }
+
+    template <typename Stored>
+    static void Invoke_(Stored& object, long)
+    {
+        object();
+    }
+
+    void MoveFrom_(InplaceCommand& other)
+    {
+        vtable_ = other.vtable_;
+        if (vtable_)
+        {
+            vtable_->move(&storage_, &other.storage_);
+            other.vtable_ = nullptr;
+        }
+    }
+
+    std::aligned_storage_t<Size, alignof(std::max_align_t)> storage_;
+    VTable_ const* vtable_{ nullptr };
+};
+
+template <std::size_t Size>
+template <typename Stored>
+constexpr typename InplaceCommand<Size>::VTable_ InplaceCommand<Size>::VTableFor_<Stored>::value;
+
+/* Command 를 상속받지 않아도 되므로, Receiver 를 위한 별도의 가상 함수가 필요없습니다. */
+class ChangeWebPageCommand
+{
+public:
+    ChangeWebPageCommand(WebPageManager& pageManager, std::string webPage)
+        : pageManager_(&pageManager), webPage_(std::move(webPage))
+    {}
+
+    void Execute()
+    {
+        pageManager_->ChangeWebPage(webPage_);
+    }
+
+private:
+    WebPageManager* pageManager_;
+    std::string webPage_;
+};
+
+/* Receiver 의 멤버 함수를 인자와 함께 묶어둡니다. */
+template <typename Receiver, typename Method, typename... Args>
+class MemberFunctionCommand
+{
+public:
+    MemberFunctionCommand(Receiver& receiver, Method method, Args... args)
+        : receiver_(&receiver), method_(method), args_(std::move(args)...)
+    {}
+
+    void operator()()
+    {
+        Call_(std::index_sequence_for<Args...>());
+    }
+
+private:
+    template <std::size_t... Indices>
+    void Call_(std::index_sequence<Indices...>)
+    {
+        (receiver_->*method_)(std::get<Indices>(args_)...);
+    }
+
+    Receiver* receiver_;
+    Method method_;
+    std::tuple<Args...> args_;
+};
+
+template <typename Receiver, typename Method, typename... Args>
+auto MakeMemberFunctionCommand(Receiver& receiver, Method method, Args... args)
+    -> MemberFunctionCommand<Receiver, Method, Args...>
+{
+    return MemberFunctionCommand<Receiver, Method, Args...>(receiver, method, std::move(args)...);
+}
+
+using Command = InplaceCommand<64>;
+
+class Button
+{
+public:
+    explicit Button(Command command)
+        : command_(std::move(command))
+    {}
+
+    void Click()
+    {
+        command_.Execute();
+    }
+
+    Command ChangeCommand(Command command)
+    {
+        Command old = std::move(command_);
+        command_ = std::move(command);
+        return old;
+    }
+
+private:
+    Command command_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Benchmark : 가상 함수 기반의 Command 를 heap 에 만드는 경우와 비교합니다.
+
+class VirtualCommand
+{
+public:
+    virtual ~VirtualCommand() = default;
+
+    virtual void Execute() = 0;
+};
+
+template <typename Receiver>
+class VirtualGenericCommand : public VirtualCommand
+{
+public:
+    explicit VirtualGenericCommand(Receiver&& receiver)
+        : receiver_(std::move(receiver))
+    {}
+
+    void Execute() override
+    {
+        receiver_();
+    }
+
+private:
+    Receiver receiver_;
+};
+
+void Benchmark(std::size_t commandCount)
+{
+    std::size_t counter = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < commandCount; ++i)
+    {
+        auto receiver = [&counter, i] { counter += i; };
+        std::unique_ptr<VirtualCommand> command =
+            std::make_unique<VirtualGenericCommand<decltype(receiver)>>(std::move(receiver));
+        command->Execute();
+    }
+    auto heapTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < commandCount; ++i)
+    {
+        Command command([&counter, i] { counter += i; });
+        command.Execute();
+    }
+    auto inplaceTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "heap + virtual : " << heapTime << " ms" << std::endl;
+    std::cout << "inplace        : " << inplaceTime << " ms" << std::endl;
+    std::cout << "(counter " << counter << ")" << std::endl;
+}
+
+/*
+    Command 객체를 heap 에 만들고 가상 함수로 호출하는 대신, 작은 내부 버퍼에 값으로
+    담아두고 직접 만든 함수 포인터 테이블로 호출합니다.
+    짧게 쓰고 버리는 Command 들을 많이 만드는 경우, heap 할당과 이중 간접 참조를 없앨 수
+    있습니다.
+*/
+int main()
+{
+    WebPageManager webPageManager;
+
+    Button button(ChangeWebPageCommand(webPageManager, "http://taeguk.me"));
+    button.Click();
+
+    button.ChangeCommand(
+        []() -> void
+        {
+            std::cout << "This is generic command." << std::endl;
+        });
+    button.Click();
+
+    button.ChangeCommand(MakeMemberFunctionCommand(webPageManager, &WebPageManager::Refresh));
+    button.Click();
+
+    button.ChangeCommand(MakeMemberFunctionCommand(
+        webPageManager, &WebPageManager::ChangeWebPage, std::string("http://github.com/taeguk")));
+    button.Click();
+
+    std::cout << "---- Benchmark (10,000,000 commands) ----" << std::endl;
+    Benchmark(10000000);
+}
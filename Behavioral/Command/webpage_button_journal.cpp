@@ -0,0 +1,678 @@
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Receiver (실제 요청을 처리할 책임을 지는 객체) */
+class WebPageManager
+{
+public:
+    void ChangeWebPage(std::string const& webPage)
+    {
+        ChangeWebPage(webPage.data(), webPage.size());
+    }
+
+    // journal 을 replay 할 때, 기록된 문자열을 복사하지 않고 그대로 넘겨받습니다.
+    void ChangeWebPage(char const* webPage, std::size_t length)
+    {
+        ++changeCount_;
+        checksum_ = checksum_ * 31 + length + (length ? static_cast<unsigned char>(webPage[length - 1]) : 0);
+        if (isVerbose_)
+        {
+            std::cout << "Change web page to " << std::string(webPage, length) << "." << std::endl;
+        }
+    }
+
+    void SetVerbose(bool isVerbose) { isVerbose_ = isVerbose; }
+    std::uint64_t GetChangeCount() const { return changeCount_; }
+    std::uint64_t GetChecksum() const { return checksum_; }
+
+private:
+    bool isVerbose_{ true };
+    std::uint64_t changeCount_{ 0 };
+    std::uint64_t checksum_{ 0 };
+};
+
+/* journal 에 기록할 수 있는 Command 의 종류 */
+enum class CommandType : std::uint16_t
+{
+    ChangeWebPage = 1
+};
+
+class Command
+{
+public:
+    virtual ~Command() = default;
+
+    virtual void Execute() = 0;
+};
+
+/* journal 에 기록될 수 있는 Command 는 자신의 종류와 내용을 직렬화할 수 있어야 합니다. */
+class SerializableCommand : public Command
+{
+public:
+    virtual CommandType GetType() const = 0;
+    virtual void Serialize(std::string& out) const = 0;
+};
+
+class ChangeWebPageCommand : public SerializableCommand
+{
+public:
+    ChangeWebPageCommand(WebPageManager& pageManager, std::string webPage)
+        : pageManager_(pageManager), webPage_(std::move(webPage))
+    {}
+
+    void Execute() override
+    {
+        pageManager_.ChangeWebPage(webPage_);
+    }
+
+    CommandType GetType() const override
+    {
+        return CommandType::ChangeWebPage;
+    }
+
+    // 내용은 URL 문자열 그대로입니다.
+    void Serialize(std::string& out) const override
+    {
+        out.append(webPage_);
+    }
+
+private:
+    WebPageManager& pageManager_;
+    std::string webPage_;
+};
+
+/*
+    Journal 파일 형식
+        [FileHeader] [Record] [Record] ...
+    각 Record 는 RecordHeader 뒤에 size 바이트의 내용이 붙고, 4 바이트 단위로 정렬됩니다.
+    RecordHeader 의 crc 는 header (crc 는 0 으로 두고) 와 내용에 대한 CRC-32 입니다.
+    crc 가 맞지 않는 Record 는 기록 도중 중단되었거나 깨진 것으로 보고, 그 뒤는 읽지 않습니다.
+    모든 정수는 little-endian 으로 기록됩니다. (이 예제는 little-endian 환경만 가정합니다.)
+*/
+namespace journal
+{
+constexpr std::uint32_t kMagic = 0x4C4E524A;    //< "JRNL"
+constexpr std::uint32_t kVersion = 2;
+
+struct FileHeader
+{
+    std::uint32_t magic;
+    std::uint32_t version;
+};
+
+struct RecordHeader
+{
+    std::uint32_t size;
+    std::uint16_t type;
+    std::uint16_t reserved;
+    std::uint32_t crc;
+};
+
+inline std::size_t AlignedRecordSize(std::size_t payloadSize)
+{
+    return (sizeof(RecordHeader) + payloadSize + 3) & ~std::size_t{ 3 };
+}
+
+// CRC-32 (IEEE 802.3, reflected)
+inline std::uint32_t Crc32(void const* data, std::size_t size, std::uint32_t crc = 0)
+{
+    static auto const table = []
+    {
+        std::array<std::uint32_t, 256> table{};
+        for (std::uint32_t i = 0; i < 256; ++i)
+        {
+            auto value = i;
+            for (int bit = 0; bit < 8; ++bit)
+            {
+                value = (value >> 1) ^ ((value & 1) ? 0xEDB88320u : 0u);
+            }
+            table[i] = value;
+        }
+        return table;
+    }();
+
+    auto const* bytes = static_cast<unsigned char const*>(data);
+    crc = ~crc;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        crc = table[(crc ^ bytes[i]) & 0xff] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+inline std::uint32_t RecordCrc(RecordHeader header, char const* payload)
+{
+    header.crc = 0;
+    return Crc32(payload, header.size, Crc32(&header, sizeof(header)));
+}
+
+// 복사 없이 mmap 된 journal 의 Record 를 가리킵니다.
+struct RecordView
+{
+    CommandType type;
+    char const* data;
+    std::size_t size;
+};
+} // namespace journal
+
+// 예외가 발생해도 닫히도록 fd 를 감쌉니다.
+class FileDescriptor
+{
+public:
+    explicit FileDescriptor(int fd)
+        : fd_(fd)
+    {}
+
+    ~FileDescriptor()
+    {
+        if (fd_ >= 0)
+        {
+            ::close(fd_);
+        }
+    }
+
+    FileDescriptor(FileDescriptor const&) = delete;
+    FileDescriptor& operator=(FileDescriptor const&) = delete;
+
+    int Get() const { return fd_; }
+
+private:
+    int fd_;
+};
+
+// 예외가 발생해도 해제되도록 mmap 된 영역을 감쌉니다.
+class MappedRegion
+{
+public:
+    MappedRegion() = default;
+
+    ~MappedRegion()
+    {
+        if (data_)
+        {
+            ::munmap(data_, size_);
+        }
+    }
+
+    MappedRegion(MappedRegion const&) = delete;
+    MappedRegion& operator=(MappedRegion const&) = delete;
+
+    // fd 의 처음 size 바이트를 읽기 전용으로 mmap 합니다.
+    void Map(int fd, std::size_t size)
+    {
+        auto* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            throw std::system_error(errno, std::generic_category(), "Fail to map journal.");
+        }
+        data_ = data;
+        size_ = size;
+    }
+
+    char const* GetData() const { return static_cast<char const*>(data_); }
+    std::size_t GetSize() const { return size_; }
+
+private:
+    void* data_{ nullptr };
+    std::size_t size_{ 0 };
+};
+
+/*
+    journal 파일을 mmap 하여, Record 들을 복사하지 않고 순서대로 읽습니다.
+    마지막 Record 가 (기록 도중 중단되어) 잘려 있거나 crc 가 맞지 않으면, 그 앞까지만 읽습니다.
+*/
+class JournalReader
+{
+public:
+    explicit JournalReader(std::string const& path)
+    {
+        FileDescriptor fd(::open(path.c_str(), O_RDONLY));
+        if (fd.Get() < 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "Fail to open journal.");
+        }
+
+        struct stat st;
+        if (::fstat(fd.Get(), &st) != 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "Fail to stat journal.");
+        }
+
+        journal::FileHeader header{};
+        auto size = static_cast<std::size_t>(st.st_size);
+        if (size < sizeof(header))
+        {
+            throw std::runtime_error("Journal is too short.");
+        }
+
+        mapping_.Map(fd.Get(), size);
+        ::madvise(const_cast<char*>(mapping_.GetData()), size, MADV_SEQUENTIAL);
+
+        std::memcpy(&header, mapping_.GetData(), sizeof(header));
+        if (header.magic != journal::kMagic || header.version != journal::kVersion)
+        {
+            throw std::runtime_error("Invalid journal header.");
+        }
+    }
+
+    template <typename Func>
+    std::size_t ForEach(Func&& func) const
+    {
+        return Scan_(func).first;
+    }
+
+    // 온전한 마지막 Record 의 끝. (그 뒤는 잘렸거나 깨진 부분입니다.)
+    std::size_t GetValidSize() const
+    {
+        return Scan_([](journal::RecordView const&) {}).second;
+    }
+
+private:
+    // 읽은 Record 의 수와, 온전한 마지막 Record 의 끝을 돌려줍니다.
+    template <typename Func>
+    std::pair<std::size_t, std::size_t> Scan_(Func&& func) const
+    {
+        auto const* base = mapping_.GetData();
+        auto const size = mapping_.GetSize();
+        std::size_t offset = sizeof(journal::FileHeader);
+        std::size_t count = 0;
+
+        while (offset + sizeof(journal::RecordHeader) <= size)
+        {
+            journal::RecordHeader header;
+            std::memcpy(&header, base + offset, sizeof(header));
+
+            auto recordSize = journal::AlignedRecordSize(header.size);
+            auto const* payload = base + offset + sizeof(header);
+            if (offset + recordSize > size || journal::RecordCrc(header, payload) != header.crc)
+            {
+                break;
+            }
+
+            func(journal::RecordView{ static_cast<CommandType>(header.type), payload, header.size });
+            offset += recordSize;
+            ++count;
+        }
+
+        return { count, offset };
+    }
+
+    MappedRegion mapping_;
+};
+
+/*
+    실행된 Command 들을 append-only 파일에 기록합니다.
+    Append 는 메모리의 버퍼에만 쌓아두고, groupSize 개가 모이거나 Commit 이 호출되면
+    한 번의 write 와 fdatasync 로 디스크에 내립니다. (group commit)
+    이미 있는 journal 을 열 때, 끝에 잘리거나 깨진 Record 가 있으면 잘라내고 그 자리부터 이어서 씁니다.
+    (그대로 두고 뒤에 이어 쓰면, replay 가 깨진 Record 에서 멈춰서 그 뒤의 Record 들을 읽지 못합니다.)
+*/
+class CommandJournal
+{
+public:
+    CommandJournal(std::string const& path, std::size_t groupSize)
+        : fd_(::open(path.c_str(), O_RDWR | O_CREAT, 0644)), groupSize_(groupSize)
+    {
+        if (fd_.Get() < 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "Fail to open journal.");
+        }
+
+        struct stat st;
+        if (::fstat(fd_.Get(), &st) != 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "Fail to stat journal.");
+        }
+
+        auto size = static_cast<std::size_t>(st.st_size);
+        if (size < sizeof(journal::FileHeader))
+        {
+            // 비어있거나, FileHeader 를 쓰다가 중단된 파일입니다.
+            Truncate_(0);
+            journal::FileHeader header{ journal::kMagic, journal::kVersion };
+            buffer_.append(reinterpret_cast<char const*>(&header), sizeof(header));
+        }
+        else
+        {
+            offset_ = JournalReader(path).GetValidSize();
+            if (offset_ < size)
+            {
+                Truncate_(offset_);
+            }
+        }
+    }
+
+    ~CommandJournal()
+    {
+        try
+        {
+            Commit();
+        }
+        catch (...)
+        {}
+    }
+
+    CommandJournal(CommandJournal const&) = delete;
+    CommandJournal& operator=(CommandJournal const&) = delete;
+
+    void Append(SerializableCommand const& command)
+    {
+        auto offset = buffer_.size();
+        buffer_.resize(offset + sizeof(journal::RecordHeader));
+        command.Serialize(buffer_);
+
+        auto payloadSize = buffer_.size() - offset - sizeof(journal::RecordHeader);
+        journal::RecordHeader header{
+            static_cast<std::uint32_t>(payloadSize), static_cast<std::uint16_t>(command.GetType()), 0, 0 };
+        header.crc = journal::RecordCrc(header, &buffer_[offset + sizeof(header)]);
+        std::memcpy(&buffer_[offset], &header, sizeof(header));
+        buffer_.resize(offset + journal::AlignedRecordSize(payloadSize), '\0');
+
+        if (++pendingCount_ >= groupSize_)
+        {
+            Commit();
+        }
+    }
+
+    void Commit()
+    {
+        if (buffer_.empty())
+        {
+            return;
+        }
+
+        // 실패하면 buffer_ 와 offset_ 을 그대로 두므로, 다음 Commit 이 같은 자리에 같은 내용을 다시 씁니다.
+        std::size_t written = 0;
+        while (written < buffer_.size())
+        {
+            auto result = ::pwrite(fd_.Get(), buffer_.data() + written, buffer_.size() - written,
+                                   static_cast<off_t>(offset_ + written));
+            if (result < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                throw std::system_error(errno, std::generic_category(), "Fail to write journal.");
+            }
+            written += static_cast<std::size_t>(result);
+        }
+        if (::fdatasync(fd_.Get()) != 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "Fail to sync journal.");
+        }
+
+        offset_ += buffer_.size();
+        buffer_.clear();
+        pendingCount_ = 0;
+    }
+
+private:
+    void Truncate_(std::size_t size)
+    {
+        if (::ftruncate(fd_.Get(), static_cast<off_t>(size)) != 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "Fail to truncate journal.");
+        }
+    }
+
+    FileDescriptor fd_;
+    std::size_t offset_{ 0 };   //< 다음 Commit 이 쓰기 시작할 파일의 위치
+    std::size_t groupSize_;
+    std::size_t pendingCount_{ 0 };
+    std::string buffer_;
+};
+
+/*
+    Record 의 종류마다 Receiver 를 호출하는 handler 를 등록해두고, journal 을 replay 합니다.
+    Command 객체를 다시 만들지 않고, Record 의 내용을 바로 Receiver 에게 넘깁니다.
+*/
+class CommandReplayer
+{
+public:
+    using Handler = std::function<void(char const* data, std::size_t size)>;
+
+    void Register(CommandType type, Handler handler)
+    {
+        auto index = static_cast<std::size_t>(type);
+        if (handlers_.size() <= index)
+        {
+            handlers_.resize(index + 1);
+        }
+        handlers_[index] = std::move(handler);
+    }
+
+    std::size_t Replay(JournalReader const& reader) const
+    {
+        return reader.ForEach([this](journal::RecordView const& record)
+        {
+            auto index = static_cast<std::size_t>(record.type);
+            if (index >= handlers_.size() || !handlers_[index])
+            {
+                throw std::runtime_error("Unknown command type in journal.");
+            }
+            handlers_[index](record.data, record.size);
+        });
+    }
+
+private:
+    std::vector<Handler> handlers_;
+};
+
+class Button
+{
+public:
+    Button(SerializableCommand* command, CommandJournal* journal)
+        : command_(command), journal_(journal)
+    {}
+
+    // 실행한 Command 를 journal 에 기록합니다.
+    void Click()
+    {
+        if (command_)
+        {
+            command_->Execute();
+            if (journal_)
+            {
+                journal_->Append(*command_);
+            }
+        }
+    }
+
+private:
+    SerializableCommand* command_;
+    CommandJournal* journal_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Recovery Test : 기록 도중 중단되어 끝이 잘린 journal 을 다시 열어 이어 쓰면, 잘린 Record 는 버려지고
+//                 그 뒤에 이어 쓴 Record 들은 replay 되어야 합니다. 내용이 깨진 Record 에서는 replay 가 멈춰야 합니다.
+
+bool RunRecoveryTest()
+{
+    std::string const path = "webpage_button_recovery.journal";
+    std::remove(path.c_str());
+
+    WebPageManager webPageManager;
+    webPageManager.SetVerbose(false);
+    ChangeWebPageCommand command(webPageManager, "http://taeguk.me");
+    auto countRecords = [&path]
+    {
+        return JournalReader(path).ForEach([](journal::RecordView const&) {});
+    };
+
+    {
+        CommandJournal journal(path, 16);
+        for (int i = 0; i < 3; ++i)
+            journal.Append(command);
+    }
+
+    // 두 번째 Record 를 쓰다가 중단된 것처럼, header 와 내용의 일부만 덧붙입니다.
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::app);
+        journal::RecordHeader header{ 64, static_cast<std::uint16_t>(CommandType::ChangeWebPage), 0, 0x12345678 };
+        file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+        file.write("http://", 7);
+    }
+    bool isCorrect = countRecords() == 3;
+
+    {
+        CommandJournal journal(path, 16);
+        for (int i = 0; i < 2; ++i)
+            journal.Append(command);
+    }
+    isCorrect = isCorrect && countRecords() == 5;
+
+    // 네 번째 Record 의 내용에서 한 bit 를 뒤집습니다.
+    {
+        std::string payload;
+        command.Serialize(payload);
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        auto offset = sizeof(journal::FileHeader) + 3 * journal::AlignedRecordSize(payload.size())
+            + sizeof(journal::RecordHeader);
+        char byte;
+        file.seekg(static_cast<std::streamoff>(offset));
+        file.read(&byte, 1);
+        byte ^= 0x04;
+        file.seekp(static_cast<std::streamoff>(offset));
+        file.write(&byte, 1);
+    }
+    isCorrect = isCorrect && countRecords() == 3;
+
+    std::remove(path.c_str());
+    return isCorrect;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Benchmark : 텍스트 로그를 한 줄씩 읽어서 Command 를 다시 만들어 실행하는 경우와 비교합니다.
+
+template <typename Func>
+double MeasureMilliseconds(Func&& func)
+{
+    auto start = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void Benchmark(std::size_t commandCount)
+{
+    std::string const journalPath = "webpage_button_benchmark.journal";
+    std::string const textLogPath = "webpage_button_benchmark.log";
+    std::remove(journalPath.c_str());
+
+    WebPageManager writeManager;
+    writeManager.SetVerbose(false);
+
+    auto writeTime = MeasureMilliseconds([&]
+    {
+        CommandJournal journal(journalPath, 4096);
+        std::ofstream textLog(textLogPath);
+        for (std::size_t i = 0; i < commandCount; ++i)
+        {
+            ChangeWebPageCommand command(writeManager, "/page/" + std::to_string(i % 100000));
+            command.Execute();
+            journal.Append(command);
+            textLog << "ChangeWebPage /page/" << i % 100000 << '\n';
+        }
+    });
+    std::cout << "write (journal + text log) : " << writeTime << " ms" << std::endl;
+
+    WebPageManager textManager;
+    textManager.SetVerbose(false);
+    auto textTime = MeasureMilliseconds([&]
+    {
+        std::ifstream textLog(textLogPath);
+        std::string line;
+        while (std::getline(textLog, line))
+        {
+            auto space = line.find(' ');
+            if (line.compare(0, space, "ChangeWebPage") == 0)
+            {
+                ChangeWebPageCommand command(textManager, line.substr(space + 1));
+                command.Execute();
+            }
+        }
+    });
+
+    WebPageManager journalManager;
+    journalManager.SetVerbose(false);
+    CommandReplayer replayer;
+    replayer.Register(CommandType::ChangeWebPage, [&journalManager](char const* data, std::size_t size)
+    {
+        journalManager.ChangeWebPage(data, size);
+    });
+    auto journalTime = MeasureMilliseconds([&]
+    {
+        JournalReader reader(journalPath);
+        replayer.Replay(reader);
+    });
+
+    std::cout << "replay text log : " << textTime << " ms" << std::endl;
+    std::cout << "replay journal  : " << journalTime << " ms" << std::endl;
+    std::cout << "(consistent : " << std::boolalpha
+        << (textManager.GetChecksum() == writeManager.GetChecksum()
+            && journalManager.GetChecksum() == writeManager.GetChecksum()) << ")" << std::endl;
+
+    std::remove(journalPath.c_str());
+    std::remove(textLogPath.c_str());
+}
+
+/*
+    Command 를 직렬화할 수 있게 하면, 실행된 Command 들을 기록해두었다가 나중에 다시
+    실행 (replay) 하여 상태를 복구할 수 있습니다.
+    (이 예제는 POSIX 의 open/write/mmap 을 사용합니다.)
+*/
+int main()
+{
+    std::string const path = "webpage_button.journal";
+    std::remove(path.c_str());
+
+    {
+        WebPageManager webPageManager;
+        CommandJournal journal(path, 16);
+
+        ChangeWebPageCommand homeCommand(webPageManager, "http://taeguk.me");
+        ChangeWebPageCommand githubCommand(webPageManager, "http://github.com/taeguk");
+        Button homeButton(&homeCommand, &journal);
+        Button githubButton(&githubCommand, &journal);
+
+        homeButton.Click();
+        githubButton.Click();
+        homeButton.Click();
+    }
+
+    std::cout << "---- Restart and replay ----" << std::endl;
+    {
+        WebPageManager webPageManager;
+        CommandReplayer replayer;
+        replayer.Register(CommandType::ChangeWebPage, [&webPageManager](char const* data, std::size_t size)
+        {
+            webPageManager.ChangeWebPage(data, size);
+        });
+
+        JournalReader reader(path);
+        std::cout << replayer.Replay(reader) << " commands were replayed." << std::endl;
+    }
+    std::remove(path.c_str());
+
+    std::cout << "Recovery test : " << (RunRecoveryTest() ? "passed" : "FAILED") << std::endl;
+
+    std::cout << "---- Benchmark (10,000,000 commands) ----" << std::endl;
+    Benchmark(10000000);
+}
@@ -0,0 +1,295 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+/* Receiver (실제 요청을 처리할 책임을 지는 객체) */
+class WebPageManager
+{
+public:
+    void ChangeWebPage(std::string const& webPage)
+    {
+        std::cout << "Change web page to " << webPage << "." << std::endl;
+    }
+};
+
+class Command
+{
+public:
+    virtual ~Command() = default;
+
+    virtual void Execute() = 0;
+};
+
+class ChangeWebPageCommand : public Command
+{
+public:
+    ChangeWebPageCommand(WebPageManager& pageManager, std::string webPage)
+        : pageManager_(pageManager), webPage_(std::move(webPage))
+    {}
+
+    void Execute() override
+    {
+        pageManager_.ChangeWebPage(webPage_);
+    }
+
+private:
+    WebPageManager& pageManager_;
+    std::string webPage_;
+};
+
+/* 템플릿을 활용해서, 임의의 Receiver에게 명령을 전달할 수 있도록 한다. */
+template <typename Receiver>
+class GenericCommand : public Command
+{
+public:
+    explicit GenericCommand(Receiver&& receiver)
+        : receiver_(std::move(receiver))
+    {}
+
+    void Execute() override
+    {
+        receiver_();
+    }
+
+    // 가상 함수를 거치지 않고 Receiver 를 바로 호출하는 thunk. (MacroCommand 에서 사용합니다.)
+    static void Invoke(void* command)
+    {
+        static_cast<GenericCommand*>(command)->receiver_();
+    }
+
+private:
+    Receiver receiver_;
+};
+
+template <typename Receiver>
+auto MakeGenericCommand(Receiver&& receiver)
+    -> GenericCommand<Receiver>
+{
+    return GenericCommand<Receiver>(std::move(receiver));
+}
+
+/*
+    여러 Command 를 묶어서 하나의 Command 처럼 실행합니다.
+    MacroCommand 를 Add 하면, 그 안의 Command 들을 그대로 펼쳐서 추가하므로,
+    몇 단계로 중첩되어 있더라도 Execute 는 하나의 연속된 배열을 순서대로 호출하는
+    반복문이 됩니다. (재귀 호출이나, 중첩된 MacroCommand 를 따라가는 일이 없습니다.)
+    GenericCommand 는 가상 함수 대신 Receiver 를 바로 호출하는 thunk 로 추가됩니다.
+    Add 시점에 펼쳐지므로, 그 뒤에 중첩된 MacroCommand 를 바꾸어도 반영되지 않습니다.
+    Command 객체의 소유권은 가지지 않습니다.
+*/
+class MacroCommand : public Command
+{
+public:
+    void Execute() override
+    {
+        for (auto const& thunk : thunks_)
+        {
+            thunk.call(thunk.command);
+        }
+    }
+
+    MacroCommand& Add(Command& command)
+    {
+        thunks_.push_back({ &ExecuteCommand_, &command });
+        return *this;
+    }
+
+    template <typename Receiver>
+    MacroCommand& Add(GenericCommand<Receiver>& command)
+    {
+        thunks_.push_back({ &GenericCommand<Receiver>::Invoke, &command });
+        return *this;
+    }
+
+    // 자기 자신을 Add 하면, 지금까지 추가된 Command 들이 한 번 더 추가됩니다.
+    MacroCommand& Add(MacroCommand& macro)
+    {
+        if (&macro == this)
+        {
+            // 자기 자신의 범위를 insert 하면 재할당 시 iterator 가 무효화되므로, 먼저 복사합니다.
+            auto thunks = thunks_;
+            thunks_.insert(thunks_.end(), thunks.begin(), thunks.end());
+        }
+        else
+        {
+            thunks_.insert(thunks_.end(), macro.thunks_.begin(), macro.thunks_.end());
+        }
+        return *this;
+    }
+
+    std::size_t GetSize() const { return thunks_.size(); }
+
+private:
+    struct Thunk_
+    {
+        void (*call)(void* command);
+        void* command;
+    };
+
+    static void ExecuteCommand_(void* command)
+    {
+        static_cast<Command*>(command)->Execute();
+    }
+
+    std::vector<Thunk_> thunks_;
+};
+
+class Button
+{
+public:
+    explicit Button(Command* command)
+        : command_(command)
+    {}
+
+    void Click()
+    {
+        if (command_)
+        {
+            command_->Execute();
+        }
+    }
+
+    Command* ChangeCommand(Command* command)
+    {
+        Command* old = command_;
+        command_ = command;
+        return old;
+    }
+
+private:
+    Command* command_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Benchmark : 자식 Command 들을 재귀적으로 실행하는 naive 한 Composite 와 비교합니다.
+
+class RecursiveMacroCommand : public Command
+{
+public:
+    void Execute() override
+    {
+        for (auto* command : commands_)
+        {
+            command->Execute();
+        }
+    }
+
+    RecursiveMacroCommand& Add(Command& command)
+    {
+        commands_.push_back(&command);
+        return *this;
+    }
+
+private:
+    std::vector<Command*> commands_;
+};
+
+void Benchmark(std::size_t depth, std::size_t fanOut, std::size_t executeCount)
+{
+    std::uint64_t counter = 0;
+    auto increment = [&counter] { ++counter; };
+    using CounterCommand = GenericCommand<decltype(increment)>;
+
+    // 각 단계마다 새로운 노드들을 만들기 위해, 객체들을 한 곳에 모아 소유합니다.
+    std::vector<std::unique_ptr<CounterCommand>> leaves;
+    std::vector<std::unique_ptr<MacroCommand>> macros;
+    std::vector<std::unique_ptr<RecursiveMacroCommand>> recursiveMacros;
+
+    std::vector<MacroCommand*> level;
+    std::vector<RecursiveMacroCommand*> recursiveLevel;
+
+    std::size_t nodeCount = 1;
+    for (std::size_t d = 0; d < depth; ++d)
+        nodeCount *= fanOut;
+
+    for (std::size_t i = 0; i < nodeCount; ++i)
+    {
+        auto receiver = increment;
+        leaves.push_back(std::make_unique<CounterCommand>(std::move(receiver)));
+    }
+
+    // 가장 아래 단계의 macro 들은 leaf 들을, 그 위의 단계는 아래 단계의 macro 들을 묶습니다.
+    for (std::size_t d = 0; d < depth; ++d)
+    {
+        std::vector<MacroCommand*> nextLevel;
+        std::vector<RecursiveMacroCommand*> nextRecursiveLevel;
+        nodeCount /= fanOut;
+
+        for (std::size_t i = 0; i < nodeCount; ++i)
+        {
+            macros.push_back(std::make_unique<MacroCommand>());
+            recursiveMacros.push_back(std::make_unique<RecursiveMacroCommand>());
+
+            for (std::size_t j = i * fanOut; j < (i + 1) * fanOut; ++j)
+            {
+                if (d == 0)
+                {
+                    macros.back()->Add(*leaves[j]);
+                    recursiveMacros.back()->Add(*leaves[j]);
+                }
+                else
+                {
+                    macros.back()->Add(*level[j]);
+                    recursiveMacros.back()->Add(*recursiveLevel[j]);
+                }
+            }
+
+            nextLevel.push_back(macros.back().get());
+            nextRecursiveLevel.push_back(recursiveMacros.back().get());
+        }
+
+        level.swap(nextLevel);
+        recursiveLevel.swap(nextRecursiveLevel);
+    }
+
+    Command& flat = *level.front();
+    Command& recursive = *recursiveLevel.front();
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < executeCount; ++i)
+        recursive.Execute();
+    auto recursiveTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < executeCount; ++i)
+        flat.Execute();
+    auto flatTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "leaves " << leaves.size() << ", depth " << depth << " : recursive " << recursiveTime
+        << " ms, flattened " << flatTime << " ms (counter " << counter << ")" << std::endl;
+}
+
+int main()
+{
+    WebPageManager webPageManager;
+    ChangeWebPageCommand homeCommand(webPageManager, "http://taeguk.me");
+    ChangeWebPageCommand githubCommand(webPageManager, "http://github.com/taeguk");
+    auto genericCommand = MakeGenericCommand(
+        []() -> void
+        {
+            std::cout << "This is generic command." << std::endl;
+        });
+
+    MacroCommand innerMacro;
+    innerMacro.Add(githubCommand).Add(genericCommand);
+
+    MacroCommand macro;
+    macro.Add(homeCommand).Add(innerMacro).Add(homeCommand);
+    std::cout << "Macro has " << macro.GetSize() << " flattened commands." << std::endl;
+
+    Button button(&macro);
+    button.Click();
+
+    MacroCommand twiceMacro;
+    twiceMacro.Add(githubCommand).Add(genericCommand).Add(twiceMacro);
+    std::cout << "Self-added macro has " << twiceMacro.GetSize() << " flattened commands." << std::endl;
+    twiceMacro.Execute();
+
+    std::cout << "---- Benchmark (10,000 executions) ----" << std::endl;
+    Benchmark(3, 6, 10000);
+    Benchmark(4, 5, 10000);
+}
@@ -0,0 +1,277 @@
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+/* Receiver (실제 요청을 처리할 책임을 지는 객체) */
+class WebPageManager
+{
+public:
+    void ChangeWebPage(std::string const& webPage)
+    {
+        ++changeCount_;
+        if (isVerbose_)
+        {
+            std::cout << "Change web page to " << webPage << "." << std::endl;
+        }
+    }
+
+    void SetVerbose(bool isVerbose) { isVerbose_ = isVerbose; }
+    std::uint64_t GetChangeCount() const { return changeCount_; }
+
+private:
+    bool isVerbose_{ true };
+    std::uint64_t changeCount_{ 0 };
+};
+
+/*
+    같은 key 를 가진 Command 들은, 마지막 것만 실행해도 결과가 같은 Command 들입니다.
+    (예를 들어, 같은 WebPageManager 의 페이지를 바꾸는 Command 들)
+    receiver 가 nullptr 인 key 는 합쳐지지 않습니다.
+*/
+struct CoalesceKey
+{
+    bool operator==(CoalesceKey const& key) const
+    {
+        return receiver == key.receiver && type == key.type;
+    }
+
+    void const* receiver{ nullptr };
+    std::type_info const* type{ nullptr };
+};
+
+class Command
+{
+public:
+    virtual ~Command() = default;
+
+    virtual void Execute() = 0;
+
+    virtual CoalesceKey GetCoalesceKey() const
+    {
+        return {};
+    }
+};
+
+class ChangeWebPageCommand : public Command
+{
+public:
+    ChangeWebPageCommand(WebPageManager& pageManager, std::string webPage)
+        : pageManager_(pageManager), webPage_(std::move(webPage))
+    {}
+
+    void Execute() override
+    {
+        pageManager_.ChangeWebPage(webPage_);
+    }
+
+    // 같은 WebPageManager 에 대한 페이지 변경은 마지막 것만 의미가 있습니다.
+    CoalesceKey GetCoalesceKey() const override
+    {
+        return { &pageManager_, &typeid(ChangeWebPageCommand) };
+    }
+
+private:
+    WebPageManager& pageManager_;
+    std::string webPage_;
+};
+
+/* 템플릿을 활용해서, 임의의 Receiver에게 명령을 전달할 수 있도록 한다. */
+template <typename Receiver>
+class GenericCommand : public Command
+{
+public:
+    explicit GenericCommand(Receiver&& receiver)
+        : receiver_(std::move(receiver))
+    {}
+
+    void Execute() override
+    {
+        receiver_();
+    }
+
+private:
+    Receiver receiver_;
+};
+
+template <typename Receiver>
+auto MakeGenericCommand(Receiver&& receiver)
+    -> GenericCommand<Receiver>
+{
+    return GenericCommand<Receiver>(std::move(receiver));
+}
+
+/*
+    여러 Button 들로부터 Command 를 모아두었다가, Flush 시에 한꺼번에 실행합니다.
+    바로 앞에 들어온 Command 와 CoalesceKey 가 같으면, 앞의 것을 그 자리에서 새 Command 로 바꿉니다.
+    사이에 다른 Command 가 끼어 있으면 합치지 않으므로, 그 Command 가 보는 상태는 순서대로 실행했을 때와 같습니다.
+    Command 객체의 소유권은 가지지 않으므로, Flush 될 때까지 살아있어야 합니다.
+*/
+class CommandQueue
+{
+public:
+    struct Statistics
+    {
+        std::uint64_t enqueued;
+        std::uint64_t coalesced;
+        std::uint64_t executed;
+    };
+
+    // batchSize 개의 Command 가 들어오면 자동으로 Flush 합니다. (0 이면 자동으로 Flush 하지 않습니다.)
+    explicit CommandQueue(std::size_t batchSize = 0)
+        : batchSize_(batchSize)
+    {}
+
+    void Enqueue(Command& command)
+    {
+        ++statistics_.enqueued;
+        ++enqueuedSinceFlush_;
+
+        auto key = command.GetCoalesceKey();
+        if (key.receiver && !pending_.empty() && key == lastKey_)
+        {
+            pending_.back() = &command;
+            ++statistics_.coalesced;
+        }
+        else
+        {
+            pending_.push_back(&command);
+            lastKey_ = key;
+        }
+
+        // 합쳐진 Command 도 세므로, 합쳐지는 Command 만 계속 들어와도 batchSize 마다 Flush 됩니다.
+        if (batchSize_ && enqueuedSinceFlush_ >= batchSize_)
+        {
+            Flush();
+        }
+    }
+
+    void Flush()
+    {
+        // Execute 도중에 새로 Enqueue 될 수 있으므로, 먼저 비워둡니다.
+        std::vector<Command*> batch;
+        batch.swap(pending_);
+        lastKey_ = {};
+        enqueuedSinceFlush_ = 0;
+
+        for (auto* command : batch)
+        {
+            command->Execute();
+            ++statistics_.executed;
+        }
+    }
+
+    Statistics GetStatistics() const { return statistics_; }
+
+private:
+    std::size_t batchSize_;
+    std::vector<Command*> pending_;
+    std::size_t enqueuedSinceFlush_ = 0;    //< 마지막 Flush 이후 Enqueue 된 Command 수 (합쳐진 것 포함)
+    CoalesceKey lastKey_;   //< pending_ 의 마지막 Command 의 key
+    Statistics statistics_{ 0, 0, 0 };
+};
+
+class Button
+{
+public:
+    explicit Button(Command* command, CommandQueue* queue = nullptr)
+        : command_(command), queue_(queue)
+    {}
+
+    // queue 가 설정되어 있으면 바로 실행하지 않고 queue 에 넣습니다.
+    void Click()
+    {
+        if (!command_)
+        {
+            return;
+        }
+
+        if (queue_)
+        {
+            queue_->Enqueue(*command_);
+        }
+        else
+        {
+            command_->Execute();
+        }
+    }
+
+    Command* ChangeCommand(Command* command)
+    {
+        Command* old = command_;
+        command_ = command;
+        return old;
+    }
+
+private:
+    Command* command_;
+    CommandQueue* queue_;
+};
+
+void PrintStatistics(CommandQueue const& queue)
+{
+    auto statistics = queue.GetStatistics();
+    std::cout << "enqueued " << statistics.enqueued << ", coalesced " << statistics.coalesced
+        << ", executed " << statistics.executed << std::endl;
+}
+
+int main()
+{
+    WebPageManager webPageManager;
+    CommandQueue queue;
+
+    ChangeWebPageCommand homeCommand(webPageManager, "http://taeguk.me");
+    ChangeWebPageCommand githubCommand(webPageManager, "http://github.com/taeguk");
+    auto genericCommand = MakeGenericCommand(
+        []() -> void
+        {
+            std::cout << "This is generic command." << std::endl;
+        });
+
+    Button homeButton(&homeCommand, &queue);
+    Button githubButton(&githubCommand, &queue);
+    Button genericButton(&genericCommand, &queue);
+
+    homeButton.Click();
+    genericButton.Click();
+    githubButton.Click();
+    homeButton.Click();
+    queue.Flush();
+    PrintStatistics(queue);
+
+    std::cout << "---- Event storm (1,000,000 clicks, batch of 1000) ----" << std::endl;
+    WebPageManager stormPageManager;
+    stormPageManager.SetVerbose(false);
+    CommandQueue stormQueue(1000);
+    std::vector<ChangeWebPageCommand> pageCommands;
+    for (int i = 0; i < 16; ++i)
+    {
+        pageCommands.emplace_back(stormPageManager, "http://taeguk.me/" + std::to_string(i));
+    }
+
+    std::uint64_t logCount = 0;
+    auto logCommand = MakeGenericCommand([&logCount]() { ++logCount; });
+
+    for (std::size_t i = 0; i < 1000000; ++i)
+    {
+        stormQueue.Enqueue(pageCommands[i % pageCommands.size()]);
+        if (i % 100 == 0)
+        {
+            stormQueue.Enqueue(logCommand);
+        }
+    }
+    stormQueue.Flush();
+    PrintStatistics(stormQueue);
+    std::cout << "web page changes : " << stormPageManager.GetChangeCount() << ", logs : " << logCount << std::endl;
+
+    // 합쳐지는 Command 만 들어와도 batchSize 마다 자동으로 Flush 되어야 합니다.
+    CommandQueue coalescingQueue(10);
+    for (int i = 0; i < 25; ++i)
+    {
+        coalescingQueue.Enqueue(pageCommands[0]);
+    }
+    auto executed = coalescingQueue.GetStatistics().executed;
+    std::cout << "auto flush of coalesced commands : executed " << executed << " -> " << (executed == 2 ? "correct" : "WRONG") << std::endl;
+}
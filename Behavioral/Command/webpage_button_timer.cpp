@@ -0,0 +1,684 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* Receiver (실제 요청을 처리할 책임을 지는 객체) */
+class WebPageManager
+{
+public:
+    void ChangeWebPage(std::string const& webPage)
+    {
+        std::cout << "Change web page to " << webPage << "." << std::endl;
+    }
+
+    void Refresh()
+    {
+        std::cout << "Refresh web page. (" << ++refreshCount_ << ")" << std::endl;
+    }
+
+private:
+    int refreshCount_{ 0 };
+};
+
+class Command
+{
+public:
+    virtual ~Command() = default;
+
+    virtual void Execute() = 0;
+};
+
+class ChangeWebPageCommand : public Command
+{
+public:
+    ChangeWebPageCommand(WebPageManager& pageManager, std::string webPage)
+        : pageManager_(pageManager), webPage_(std::move(webPage))
+    {}
+
+    void Execute() override
+    {
+        pageManager_.ChangeWebPage(webPage_);
+    }
+
+private:
+    WebPageManager& pageManager_;
+    std::string webPage_;
+};
+
+class RefreshWebPageCommand : public Command
+{
+public:
+    explicit RefreshWebPageCommand(WebPageManager& pageManager)
+        : pageManager_(pageManager)
+    {}
+
+    void Execute() override
+    {
+        pageManager_.Refresh();
+    }
+
+private:
+    WebPageManager& pageManager_;
+};
+
+/* 템플릿을 활용해서, 임의의 Receiver에게 명령을 전달할 수 있도록 한다. */
+template <typename Receiver>
+class GenericCommand : public Command
+{
+public:
+    explicit GenericCommand(Receiver&& receiver)
+        : receiver_(std::move(receiver))
+    {}
+
+    void Execute() override
+    {
+        receiver_();
+    }
+
+private:
+    Receiver receiver_;
+};
+
+template <typename Receiver>
+auto MakeGenericCommand(Receiver&& receiver)
+    -> GenericCommand<Receiver>
+{
+    return GenericCommand<Receiver>(std::move(receiver));
+}
+
+struct TimerId
+{
+    std::uint32_t index;
+    std::uint32_t generation;
+};
+
+/*
+    계층적 타이머 휠 (Hierarchical Timer Wheel)
+    256 칸짜리 휠 4 개로, 2^32 tick 까지의 지연을 표현합니다.
+    가장 아래의 휠은 앞으로 256 tick 안에 만료될 타이머들을 tick 단위로 담고,
+    위의 휠들은 점점 더 넓은 범위를 한 칸에 담습니다. 아래 휠이 한 바퀴를 돌 때마다,
+    위 휠의 다음 칸에 있는 타이머들을 아래 휠로 내려보냅니다. (cascade)
+    타이머는 미리 할당된 node pool 의 이중 연결 리스트로 관리되므로,
+    추가와 취소는 모두 O(1) 입니다.
+    Command 객체의 소유권은 가지지 않으므로, 만료되거나 취소될 때까지 살아있어야 합니다.
+    (thread-safe 하지 않습니다. 여러 thread 에서 사용하려면 TimerWheelDriver 를 사용하세요.)
+*/
+class TimerWheel
+{
+public:
+    // 만료된 타이머의 id 와 Command 를 넘겨받아 실행합니다. (직접 실행하거나, executor 에 넘길 수 있습니다.
+    // executor 에 넘긴다면, Command 는 executor 가 실행을 마칠 때까지 살아있어야 합니다.)
+    using Dispatcher = std::function<void(TimerId, Command&)>;
+
+    static constexpr std::size_t kSlotBits = 8;
+    static constexpr std::size_t kSlotCount = std::size_t{ 1 } << kSlotBits;
+    static constexpr std::size_t kLevelCount = 4;
+    static constexpr std::uint64_t kMaxDelay = (std::uint64_t{ 1 } << (kSlotBits * kLevelCount)) - 1;
+
+    explicit TimerWheel(Dispatcher dispatcher)
+        : dispatcher_(std::move(dispatcher))
+    {
+        for (auto& level : wheels_)
+        {
+            level.fill(kNil_);
+        }
+    }
+
+    TimerWheel(TimerWheel const&) = delete;
+    TimerWheel& operator=(TimerWheel const&) = delete;
+
+    // delay tick 뒤에 실행합니다. period 가 0 이 아니면, 그 뒤로 period tick 마다 반복합니다.
+    // delay 와 period 는 kMaxDelay 를 넘을 수 없습니다. (delay 가 0 이면 다음 tick 에 실행합니다.)
+    TimerId Schedule(Command& command, std::uint64_t delay, std::uint64_t period = 0)
+    {
+        if (delay > kMaxDelay || period > kMaxDelay)
+        {
+            throw std::invalid_argument("Timer delay or period is too long.");
+        }
+
+        auto index = AllocateNode_();
+        auto& node = nodes_[index];
+        node.command = &command;
+        node.period = period;
+        node.expireTick = currentTick_ + std::max<std::uint64_t>(delay, 1);
+
+        Link_(index);
+        ++pendingCount_;
+        return { index, node.generation };
+    }
+
+    // 이미 만료되었거나 취소된 타이머라면 false 를 반환합니다.
+    bool Cancel(TimerId id)
+    {
+        if (id.index >= nodes_.size())
+        {
+            return false;
+        }
+
+        auto& node = nodes_[id.index];
+        if (node.generation != id.generation || node.slot == kNil_)
+        {
+            return false;
+        }
+
+        Unlink_(id.index);
+        FreeNode_(id.index);
+        --pendingCount_;
+        return true;
+    }
+
+    // ticks 만큼 시간을 진행하면서, 만료된 타이머들을 실행합니다.
+    void Advance(std::uint64_t ticks)
+    {
+        for (std::uint64_t i = 0; i < ticks; ++i)
+        {
+            Tick_();
+        }
+    }
+
+    std::uint64_t GetCurrentTick() const { return currentTick_; }
+    std::size_t GetPendingCount() const { return pendingCount_; }
+
+private:
+    static constexpr std::uint32_t kNil_ = ~std::uint32_t{ 0 };
+
+    struct Node_
+    {
+        Command* command{ nullptr };
+        std::uint64_t expireTick{ 0 };
+        std::uint64_t period{ 0 };
+        std::uint32_t prev{ kNil_ };
+        std::uint32_t next{ kNil_ };
+        std::uint32_t slot{ kNil_ };        //< 들어있는 칸의 번호 (level * kSlotCount + index)
+        std::uint32_t generation{ 0 };
+    };
+
+    std::uint32_t& SlotHead_(std::uint32_t slot)
+    {
+        return wheels_[slot / kSlotCount][slot % kSlotCount];
+    }
+
+    std::uint32_t AllocateNode_()
+    {
+        if (freeHead_ != kNil_)
+        {
+            auto index = freeHead_;
+            freeHead_ = nodes_[index].next;
+            return index;
+        }
+        nodes_.emplace_back();
+        return static_cast<std::uint32_t>(nodes_.size() - 1);
+    }
+
+    void FreeNode_(std::uint32_t index)
+    {
+        auto& node = nodes_[index];
+        node.command = nullptr;
+        node.slot = kNil_;
+        ++node.generation;
+        node.next = freeHead_;
+        freeHead_ = index;
+    }
+
+    void Link_(std::uint32_t index)
+    {
+        auto& node = nodes_[index];
+        auto delta = node.expireTick > currentTick_ ? node.expireTick - currentTick_ : 0;
+
+        std::size_t level = 0;
+        while (level + 1 < kLevelCount && delta >= (std::uint64_t{ 1 } << (kSlotBits * (level + 1))))
+        {
+            ++level;
+        }
+
+        auto tick = std::max(node.expireTick, currentTick_);
+        auto slot = static_cast<std::uint32_t>(level * kSlotCount + ((tick >> (kSlotBits * level)) & (kSlotCount - 1)));
+
+        auto& head = SlotHead_(slot);
+        node.slot = slot;
+        node.prev = kNil_;
+        node.next = head;
+        if (head != kNil_)
+        {
+            nodes_[head].prev = index;
+        }
+        head = index;
+    }
+
+    void Unlink_(std::uint32_t index)
+    {
+        auto& node = nodes_[index];
+        if (node.prev != kNil_)
+            nodes_[node.prev].next = node.next;
+        else
+            SlotHead_(node.slot) = node.next;
+
+        if (node.next != kNil_)
+            nodes_[node.next].prev = node.prev;
+
+        node.slot = kNil_;
+    }
+
+    // 한 칸의 타이머들을 모두 떼어내서, 연결 리스트의 head 를 반환합니다.
+    std::uint32_t Detach_(std::uint32_t slot)
+    {
+        auto& head = SlotHead_(slot);
+        auto list = head;
+        head = kNil_;
+        return list;
+    }
+
+    void Cascade_(std::size_t level)
+    {
+        auto index = (currentTick_ >> (kSlotBits * level)) & (kSlotCount - 1);
+        auto list = Detach_(static_cast<std::uint32_t>(level * kSlotCount + index));
+
+        while (list != kNil_)
+        {
+            auto next = nodes_[list].next;
+            Link_(list);
+            list = next;
+        }
+
+        if (index == 0 && level + 1 < kLevelCount)
+        {
+            Cascade_(level + 1);
+        }
+    }
+
+    void Tick_()
+    {
+        auto index = currentTick_ & (kSlotCount - 1);
+        if (index == 0 && currentTick_ != 0)
+        {
+            Cascade_(1);
+        }
+
+        // 하나씩 떼어내면서 실행하므로, dispatcher 안에서 같은 tick 의 다른 타이머를 취소해도 안전합니다.
+        auto& head = SlotHead_(static_cast<std::uint32_t>(index));
+        while (head != kNil_)
+        {
+            auto current = head;
+            Unlink_(current);
+
+            auto& node = nodes_[current];
+            auto* command = node.command;
+            TimerId id{ current, node.generation };
+            if (node.period)
+            {
+                node.expireTick = currentTick_ + node.period;
+                Link_(current);
+            }
+            else
+            {
+                FreeNode_(current);
+                --pendingCount_;
+            }
+
+            dispatcher_(id, *command);
+        }
+
+        ++currentTick_;
+    }
+
+    Dispatcher dispatcher_;
+    std::array<std::array<std::uint32_t, kSlotCount>, kLevelCount> wheels_;
+    std::vector<Node_> nodes_;
+    std::uint32_t freeHead_{ kNil_ };
+    std::uint64_t currentTick_{ 0 };
+    std::size_t pendingCount_{ 0 };
+};
+
+constexpr std::size_t TimerWheel::kSlotBits;
+constexpr std::size_t TimerWheel::kSlotCount;
+constexpr std::size_t TimerWheel::kLevelCount;
+constexpr std::uint64_t TimerWheel::kMaxDelay;
+constexpr std::uint32_t TimerWheel::kNil_;
+
+/*
+    하나의 driver thread 가 실제 시간에 맞추어 TimerWheel 을 진행시킵니다.
+    Schedule 과 Cancel 은 어느 thread 에서나 호출할 수 있습니다.
+    만료된 Command 들은 lock 을 놓은 뒤에 하나씩 dispatcher 로 넘겨지므로, dispatcher 안에서
+    다시 Schedule 하거나 Cancel 해도 됩니다.
+    Cancel 이 true 를 반환하면 그 뒤로 Command 는 실행되지 않고, false 를 반환하면 이미 실행이 끝난 것입니다.
+    (만료되었지만 아직 dispatcher 로 넘겨지지 않은 Command 는 Cancel 이 빼내고, dispatcher 로 넘겨지는
+    중이라면 dispatcher 가 반환할 때까지 기다립니다. 따라서 Cancel 이 반환된 뒤에는 Command 객체를 없애도 됩니다.)
+*/
+class TimerWheelDriver
+{
+public:
+    // Command 를 반환하기 전에 실행해야 합니다. Cancel 은 dispatcher 가 반환할 때까지만 기다리므로,
+    // executor 에 넘기고 바로 반환하면 Cancel 이 반환된 뒤에도 Command 가 실행될 수 있습니다.
+    using Dispatcher = std::function<void(Command&)>;
+
+    TimerWheelDriver(std::chrono::microseconds tickDuration, Dispatcher dispatcher)
+        : tickDuration_(tickDuration),
+          dispatcher_(std::move(dispatcher)),
+          wheel_([this](TimerId id, Command& command) { fired_.push_back({ id, &command }); }),
+          thread_([this] { Run_(); })
+    {}
+
+    ~TimerWheelDriver()
+    {
+        stop_.store(true);
+        thread_.join();
+    }
+
+    TimerId Schedule(Command& command, std::chrono::microseconds delay, std::chrono::microseconds period = {})
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return wheel_.Schedule(command, ToTicks_(delay), ToTicks_(period));
+    }
+
+    bool Cancel(TimerId id)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto isCancelled = wheel_.Cancel(id);
+        for (auto& fired : fired_)
+        {
+            if (fired.command && IsSameTimer_(fired.id, id))
+            {
+                fired.command = nullptr;
+                isCancelled = true;
+            }
+        }
+
+        // dispatcher 안에서 자기 자신을 취소하는 경우에는, 기다리면 끝나지 않습니다.
+        if (std::this_thread::get_id() != thread_.get_id())
+        {
+            dispatchDone_.wait(lock, [&] { return !isDispatching_ || !IsSameTimer_(dispatchingId_, id); });
+        }
+        return isCancelled;
+    }
+
+private:
+    struct Fired_
+    {
+        TimerId id;
+        Command* command;   //< 취소되면 nullptr
+    };
+
+    static bool IsSameTimer_(TimerId lhs, TimerId rhs)
+    {
+        return lhs.index == rhs.index && lhs.generation == rhs.generation;
+    }
+
+    std::uint64_t ToTicks_(std::chrono::microseconds duration) const
+    {
+        return static_cast<std::uint64_t>((duration.count() + tickDuration_.count() - 1) / tickDuration_.count());
+    }
+
+    void Run_()
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        while (!stop_.load())
+        {
+            auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+            auto targetTick = static_cast<std::uint64_t>(elapsed / tickDuration_);
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                if (targetTick > wheel_.GetCurrentTick())
+                {
+                    wheel_.Advance(targetTick - wheel_.GetCurrentTick());
+                }
+
+                // 하나씩 lock 을 놓고 넘기는 동안, Cancel 이 아직 넘기지 않은 것들을 빼낼 수 있습니다.
+                for (std::size_t i = 0; i < fired_.size(); ++i)
+                {
+                    auto fired = fired_[i];
+                    if (!fired.command)
+                    {
+                        continue;
+                    }
+                    fired_[i].command = nullptr;
+
+                    isDispatching_ = true;
+                    dispatchingId_ = fired.id;
+                    lock.unlock();
+                    dispatcher_(*fired.command);
+                    lock.lock();
+                    isDispatching_ = false;
+                    dispatchDone_.notify_all();
+                }
+                fired_.clear();
+            }
+
+            std::this_thread::sleep_for(tickDuration_);
+        }
+    }
+
+    std::chrono::microseconds tickDuration_;
+    Dispatcher dispatcher_;
+    std::mutex mutex_;
+    std::condition_variable dispatchDone_;
+    std::vector<Fired_> fired_;             //< 만료되었지만 아직 dispatcher 로 넘기지 않은 것들
+    bool isDispatching_{ false };
+    TimerId dispatchingId_{ 0, 0 };
+    TimerWheel wheel_;
+    std::atomic<bool> stop_{ false };
+    std::thread thread_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Cancel Test : 만료될 즈음에 Cancel 을 부릅니다. true 를 받았다면 Command 는 실행되지 않았고 앞으로도 실행되지 않아야 하며,
+//               false 를 받았다면 이미 실행이 끝나 있어야 합니다.
+
+class CountingCommand : public Command
+{
+public:
+    void Execute() override
+    {
+        // 실행 도중에 Cancel 이 끼어들 틈을 넓힙니다.
+        std::this_thread::sleep_for(std::chrono::microseconds(20));
+        count.fetch_add(1);
+    }
+
+    std::atomic<int> count{ 0 };
+};
+
+bool RunCancelTest(std::size_t timerCount)
+{
+    using namespace std::chrono_literals;
+
+    std::vector<CountingCommand> commands(timerCount);
+    std::vector<int> isCancelled(timerCount);
+    bool isCorrect = true;
+    {
+        TimerWheelDriver driver(100us, [](Command& command) { command.Execute(); });
+
+        // i 번째 타이머는 1 ms + 50i us 뒤에 만료되고, 그 즈음에 취소합니다.
+        std::vector<TimerId> ids(timerCount);
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < timerCount; ++i)
+        {
+            ids[i] = driver.Schedule(commands[i], 1ms + std::chrono::microseconds(50 * i));
+        }
+
+        for (std::size_t i = 0; i < timerCount; ++i)
+        {
+            std::this_thread::sleep_until(start + 1250us + std::chrono::microseconds(50 * i));
+            isCancelled[i] = driver.Cancel(ids[i]);
+            isCorrect = isCorrect && commands[i].count.load() == (isCancelled[i] ? 0 : 1);
+        }
+    }
+
+    // driver 가 멈춘 뒤에도, 취소된 Command 는 실행되지 않았어야 합니다.
+    std::size_t cancelledCount = 0;
+    for (std::size_t i = 0; i < timerCount; ++i)
+    {
+        isCorrect = isCorrect && commands[i].count.load() == (isCancelled[i] ? 0 : 1);
+        cancelledCount += isCancelled[i];
+    }
+    std::cout << "Cancel test : " << cancelledCount << " of " << timerCount << " cancelled -> "
+        << (isCorrect ? "passed" : "FAILED") << std::endl;
+    return isCorrect;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Benchmark : std::priority_queue 를 사용하는 스케줄러와 비교합니다.
+// (priority_queue 는 중간의 원소를 지울 수 없으므로, 취소는 표시만 해두고 꺼낼 때 무시합니다.)
+
+class HeapScheduler
+{
+public:
+    std::uint64_t Schedule(Command& command, std::uint64_t delay)
+    {
+        auto id = nextId_++;
+        heap_.push({ currentTick_ + delay, id, &command });
+        cancelled_.push_back(false);
+        return id;
+    }
+
+    void Cancel(std::uint64_t id)
+    {
+        cancelled_[id] = true;
+    }
+
+    void Advance(std::uint64_t ticks)
+    {
+        currentTick_ += ticks;
+        while (!heap_.empty() && heap_.top().expireTick <= currentTick_)
+        {
+            auto entry = heap_.top();
+            heap_.pop();
+            if (!cancelled_[entry.id])
+            {
+                entry.command->Execute();
+            }
+        }
+    }
+
+private:
+    struct Entry_
+    {
+        bool operator<(Entry_ const& entry) const { return expireTick > entry.expireTick; }
+
+        std::uint64_t expireTick;
+        std::uint64_t id;
+        Command* command;
+    };
+
+    std::priority_queue<Entry_> heap_;
+    std::vector<bool> cancelled_;
+    std::uint64_t nextId_{ 0 };
+    std::uint64_t currentTick_{ 0 };
+};
+
+template <typename Func>
+double MeasureNanosecondsPerOp(std::size_t opCount, Func&& func)
+{
+    auto start = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / opCount;
+}
+
+void Benchmark(std::size_t timerCount, std::uint64_t maxDelay)
+{
+    std::uint64_t firedCount = 0;
+    auto countCommand = MakeGenericCommand([&firedCount] { ++firedCount; });
+
+    std::mt19937_64 random(42);
+    std::vector<std::uint64_t> delays(timerCount);
+    for (auto& delay : delays)
+    {
+        delay = 1 + random() % maxDelay;
+    }
+
+    // Timer Wheel
+    TimerWheel wheel([](TimerId, Command& command) { command.Execute(); });
+    std::vector<TimerId> ids(timerCount);
+
+    auto wheelInsert = MeasureNanosecondsPerOp(timerCount, [&]
+    {
+        for (std::size_t i = 0; i < timerCount; ++i)
+            ids[i] = wheel.Schedule(countCommand, delays[i]);
+    });
+    // churn : 절반을 취소하고, 다시 넣습니다.
+    auto wheelChurn = MeasureNanosecondsPerOp(timerCount, [&]
+    {
+        for (std::size_t i = 0; i < timerCount; i += 2)
+        {
+            wheel.Cancel(ids[i]);
+            ids[i] = wheel.Schedule(countCommand, delays[i + 1 < timerCount ? i + 1 : 0]);
+        }
+    });
+    auto wheelFire = MeasureNanosecondsPerOp(timerCount, [&]
+    {
+        wheel.Advance(maxDelay + 1);
+    });
+    auto wheelFired = firedCount;
+
+    // Priority Queue
+    firedCount = 0;
+    HeapScheduler heap;
+    std::vector<std::uint64_t> heapIds(timerCount);
+
+    auto heapInsert = MeasureNanosecondsPerOp(timerCount, [&]
+    {
+        for (std::size_t i = 0; i < timerCount; ++i)
+            heapIds[i] = heap.Schedule(countCommand, delays[i]);
+    });
+    auto heapChurn = MeasureNanosecondsPerOp(timerCount, [&]
+    {
+        for (std::size_t i = 0; i < timerCount; i += 2)
+        {
+            heap.Cancel(heapIds[i]);
+            heapIds[i] = heap.Schedule(countCommand, delays[i + 1 < timerCount ? i + 1 : 0]);
+        }
+    });
+    auto heapFire = MeasureNanosecondsPerOp(timerCount, [&]
+    {
+        for (std::uint64_t tick = 0; tick <= maxDelay; ++tick)
+            heap.Advance(1);
+    });
+
+    std::cout << "timer wheel    : insert " << wheelInsert << " ns, cancel+insert " << wheelChurn * 2
+        << " ns, fire " << wheelFire << " ns (fired " << wheelFired << ")" << std::endl;
+    std::cout << "priority queue : insert " << heapInsert << " ns, cancel+insert " << heapChurn * 2
+        << " ns, fire " << heapFire << " ns (fired " << firedCount << ")" << std::endl;
+}
+
+int main()
+{
+    using namespace std::chrono_literals;
+
+    WebPageManager webPageManager;
+    ChangeWebPageCommand homeCommand(webPageManager, "http://taeguk.me");
+    ChangeWebPageCommand githubCommand(webPageManager, "http://github.com/taeguk");
+    RefreshWebPageCommand refreshCommand(webPageManager);
+
+    {
+        TimerWheelDriver driver(1ms, [](Command& command) { command.Execute(); });
+
+        driver.Schedule(homeCommand, 10ms);
+        auto githubTimer = driver.Schedule(githubCommand, 30ms);
+        auto refreshTimer = driver.Schedule(refreshCommand, 20ms, 20ms);
+
+        std::this_thread::sleep_for(15ms);
+        std::cout << "Cancel github page change : " << std::boolalpha << driver.Cancel(githubTimer) << std::endl;
+
+        std::this_thread::sleep_for(100ms);
+        driver.Cancel(refreshTimer);
+        std::cout << "Cancel periodic refresh." << std::endl;
+    }
+
+    RunCancelTest(1000);
+
+    std::cout << "---- Benchmark (1,000,000 pending timers) ----" << std::endl;
+    Benchmark(1000000, 1 << 20);
+}
@@ -0,0 +1,427 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/* Receiver (실제 요청을 처리할 책임을 지는 객체) */
+class WebPageManager
+{
+public:
+    std::string ChangeWebPage(std::string webPage)
+    {
+        if (isVerbose_)
+        {
+            std::cout << "Change web page to " << webPage << "." << std::endl;
+        }
+        std::swap(webPage_, webPage);
+        return webPage;
+    }
+
+    std::string const& GetWebPage() const { return webPage_; }
+    void SetVerbose(bool isVerbose) { isVerbose_ = isVerbose; }
+
+private:
+    std::string webPage_{ "about:blank" };
+    bool isVerbose_{ true };
+};
+
+class Command
+{
+public:
+    virtual ~Command() = default;
+
+    virtual void Execute() = 0;
+};
+
+class UndoableCommand : public Command
+{
+public:
+    // 직전의 Execute 가 바꾼 것을 되돌립니다.
+    virtual void Undo() = 0;
+};
+
+class ChangeWebPageCommand : public UndoableCommand
+{
+public:
+    ChangeWebPageCommand(WebPageManager& pageManager, std::string webPage)
+        : pageManager_(pageManager), webPage_(std::move(webPage))
+    {}
+
+    void Execute() override
+    {
+        previousWebPage_ = pageManager_.ChangeWebPage(webPage_);
+    }
+
+    void Undo() override
+    {
+        pageManager_.ChangeWebPage(previousWebPage_);
+    }
+
+private:
+    WebPageManager& pageManager_;
+    std::string webPage_;
+    std::string previousWebPage_;
+};
+
+/* 템플릿을 활용해서, 임의의 Receiver에게 명령을 전달할 수 있도록 한다. */
+template <typename Receiver, typename UndoReceiver>
+class GenericUndoableCommand : public UndoableCommand
+{
+public:
+    GenericUndoableCommand(Receiver&& receiver, UndoReceiver&& undoReceiver)
+        : receiver_(std::move(receiver)), undoReceiver_(std::move(undoReceiver))
+    {}
+
+    void Execute() override
+    {
+        receiver_();
+    }
+
+    void Undo() override
+    {
+        undoReceiver_();
+    }
+
+private:
+    Receiver receiver_;
+    UndoReceiver undoReceiver_;
+};
+
+template <typename Receiver, typename UndoReceiver>
+auto MakeGenericUndoableCommand(Receiver&& receiver, UndoReceiver&& undoReceiver)
+    -> GenericUndoableCommand<Receiver, UndoReceiver>
+{
+    return GenericUndoableCommand<Receiver, UndoReceiver>(std::move(receiver), std::move(undoReceiver));
+}
+
+/*
+    실행한 Command 들을 미리 할당해둔 고정 크기의 arena 에 그대로 (in-place) 저장하여
+    undo/redo 를 제공합니다.
+    Command 마다 heap 할당을 하지 않고, arena 를 ring buffer 처럼 사용하므로,
+    공간이 모자라면 가장 오래된 Command 부터 O(1) 에 버립니다.
+    새로운 Command 를 실행하면, redo 할 수 있던 Command 들은 버려집니다.
+*/
+class CommandHistory
+{
+public:
+    CommandHistory(std::size_t capacityBytes, std::size_t maxEntries)
+        : arena_(new Block_[(capacityBytes + sizeof(Block_) - 1) / sizeof(Block_)]),
+          capacity_((capacityBytes + sizeof(Block_) - 1) / sizeof(Block_) * sizeof(Block_)),
+          slots_(maxEntries)
+    {
+        if (maxEntries == 0)
+        {
+            throw std::invalid_argument("History needs at least one entry.");
+        }
+    }
+
+    ~CommandHistory()
+    {
+        while (count_ > 0)
+        {
+            EvictOldest_();
+        }
+    }
+
+    CommandHistory(CommandHistory const&) = delete;
+    CommandHistory& operator=(CommandHistory const&) = delete;
+
+    template <typename ConcreteCommand>
+    void Execute(ConcreteCommand&& command)
+    {
+        using Stored = std::decay_t<ConcreteCommand>;
+        static_assert(std::is_base_of<UndoableCommand, Stored>::value, "Command must be undoable.");
+        static_assert(alignof(Stored) <= alignof(Block_), "Command is over-aligned.");
+
+        DiscardRedo_();
+
+        auto size = (sizeof(Stored) + sizeof(Block_) - 1) / sizeof(Block_) * sizeof(Block_);
+        if (size > capacity_)
+        {
+            throw std::length_error("Command is too big for the history.");
+        }
+
+        std::size_t offset;
+        while (count_ == slots_.size() || !FindRoom_(size, offset))
+        {
+            EvictOldest_();
+        }
+
+        auto* stored = new (Bytes_() + offset) Stored(std::forward<ConcreteCommand>(command));
+        try
+        {
+            stored->Execute();
+        }
+        catch (...)
+        {
+            // 실행되지 않은 Command 는 기록하지 않습니다. (slot 에 없으므로 여기서 소멸시켜야 합니다.)
+            stored->~Stored();
+            throw;
+        }
+
+        slots_[SlotIndex_(count_)] = { stored, offset, size };
+        writeOffset_ = offset + size;
+        ++count_;
+        ++cursor_;
+    }
+
+    bool Undo()
+    {
+        if (cursor_ == 0)
+        {
+            return false;
+        }
+        slots_[SlotIndex_(--cursor_)].command->Undo();
+        return true;
+    }
+
+    bool Redo()
+    {
+        if (cursor_ == count_)
+        {
+            return false;
+        }
+        slots_[SlotIndex_(cursor_++)].command->Execute();
+        return true;
+    }
+
+    std::size_t GetUndoCount() const { return cursor_; }
+    std::size_t GetRedoCount() const { return count_ - cursor_; }
+    std::uint64_t GetEvictedCount() const { return evictedCount_; }
+
+private:
+    struct Slot_
+    {
+        UndoableCommand* command;
+        std::size_t offset;
+        std::size_t size;
+    };
+
+    using Block_ = std::aligned_storage_t<alignof(std::max_align_t), alignof(std::max_align_t)>;
+
+    char* Bytes_() { return reinterpret_cast<char*>(arena_.get()); }
+
+    std::size_t SlotIndex_(std::size_t index) const
+    {
+        return (oldestSlot_ + index) % slots_.size();
+    }
+
+    // arena 에서 size 바이트의 연속된 빈 공간을 찾습니다.
+    bool FindRoom_(std::size_t size, std::size_t& offset) const
+    {
+        if (count_ == 0)
+        {
+            offset = 0;
+            return true;
+        }
+
+        auto oldestOffset = slots_[oldestSlot_].offset;
+
+        if (writeOffset_ > oldestOffset)
+        {
+            if (writeOffset_ + size <= capacity_)
+            {
+                offset = writeOffset_;
+                return true;
+            }
+            if (size <= oldestOffset)
+            {
+                offset = 0;
+                return true;
+            }
+            return false;
+        }
+
+        if (writeOffset_ < oldestOffset && writeOffset_ + size <= oldestOffset)
+        {
+            offset = writeOffset_;
+            return true;
+        }
+        return false;
+    }
+
+    void EvictOldest_()
+    {
+        auto& slot = slots_[oldestSlot_];
+        slot.command->~UndoableCommand();
+        slot.command = nullptr;
+
+        oldestSlot_ = (oldestSlot_ + 1) % slots_.size();
+        --count_;
+        if (cursor_ > 0)
+        {
+            --cursor_;
+        }
+        if (count_ == 0)
+        {
+            writeOffset_ = 0;
+        }
+        ++evictedCount_;
+    }
+
+    void DiscardRedo_()
+    {
+        while (count_ > cursor_)
+        {
+            auto& slot = slots_[SlotIndex_(count_ - 1)];
+            slot.command->~UndoableCommand();
+            slot.command = nullptr;
+            --count_;
+            writeOffset_ = count_ ? slots_[SlotIndex_(count_ - 1)].offset + slots_[SlotIndex_(count_ - 1)].size : 0;
+        }
+    }
+
+    std::unique_ptr<Block_[]> arena_;
+    std::size_t capacity_;
+    std::vector<Slot_> slots_;
+
+    std::size_t oldestSlot_{ 0 };
+    std::size_t count_{ 0 };        //< 저장된 Command 수 (redo 할 수 있는 것 포함)
+    std::size_t cursor_{ 0 };       //< 적용되어 있는 Command 수
+    std::size_t writeOffset_{ 0 };  //< 가장 최근 Command 의 끝
+    std::uint64_t evictedCount_{ 0 };
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Benchmark : Command 마다 unique_ptr 로 heap 에 할당하는 history 와 비교합니다.
+
+class NaiveCommandHistory
+{
+public:
+    explicit NaiveCommandHistory(std::size_t maxEntries)
+        : maxEntries_(maxEntries)
+    {}
+
+    void Execute(std::unique_ptr<UndoableCommand> command)
+    {
+        undoStack_.resize(cursor_);
+        command->Execute();
+        undoStack_.push_back(std::move(command));
+        if (undoStack_.size() > maxEntries_)
+        {
+            undoStack_.pop_front();
+        }
+        cursor_ = undoStack_.size();
+    }
+
+    bool Undo()
+    {
+        if (cursor_ == 0)
+            return false;
+        undoStack_[--cursor_]->Undo();
+        return true;
+    }
+
+    bool Redo()
+    {
+        if (cursor_ == undoStack_.size())
+            return false;
+        undoStack_[cursor_++]->Execute();
+        return true;
+    }
+
+private:
+    std::size_t maxEntries_;
+    std::size_t cursor_{ 0 };
+    std::deque<std::unique_ptr<UndoableCommand>> undoStack_;
+};
+
+template <typename Func>
+double MeasureNanosecondsPerOp(std::size_t opCount, Func&& func)
+{
+    auto start = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / opCount;
+}
+
+void Benchmark(std::size_t stepCount)
+{
+    std::int64_t value = 0;
+    auto makeCommand = [&value](std::int64_t delta)
+    {
+        return MakeGenericUndoableCommand([&value, delta] { value += delta; }, [&value, delta] { value -= delta; });
+    };
+    using StepCommand = decltype(makeCommand(0));
+
+    CommandHistory history(stepCount * 64, stepCount);
+    NaiveCommandHistory naiveHistory(stepCount);
+
+    auto naiveExecute = MeasureNanosecondsPerOp(stepCount * 2, [&]
+    {
+        for (std::size_t i = 0; i < stepCount * 2; ++i)
+            naiveHistory.Execute(std::make_unique<StepCommand>(makeCommand(static_cast<std::int64_t>(i))));
+    });
+    auto naiveUndo = MeasureNanosecondsPerOp(stepCount, [&]
+    {
+        for (std::size_t i = 0; i < stepCount; ++i)
+            naiveHistory.Undo();
+    });
+    auto naiveRedo = MeasureNanosecondsPerOp(stepCount, [&]
+    {
+        for (std::size_t i = 0; i < stepCount; ++i)
+            naiveHistory.Redo();
+    });
+
+    auto arenaExecute = MeasureNanosecondsPerOp(stepCount * 2, [&]
+    {
+        for (std::size_t i = 0; i < stepCount * 2; ++i)
+            history.Execute(makeCommand(static_cast<std::int64_t>(i)));
+    });
+    auto arenaUndo = MeasureNanosecondsPerOp(stepCount, [&]
+    {
+        for (std::size_t i = 0; i < stepCount; ++i)
+            history.Undo();
+    });
+    auto arenaRedo = MeasureNanosecondsPerOp(stepCount, [&]
+    {
+        for (std::size_t i = 0; i < stepCount; ++i)
+            history.Redo();
+    });
+
+    std::cout << "unique_ptr history : execute " << naiveExecute << " ns, undo " << naiveUndo
+        << " ns, redo " << naiveRedo << " ns" << std::endl;
+    std::cout << "arena history      : execute " << arenaExecute << " ns, undo " << arenaUndo
+        << " ns, redo " << arenaRedo << " ns (evicted " << history.GetEvictedCount() << ")" << std::endl;
+}
+
+int main()
+{
+    WebPageManager webPageManager;
+
+    // 작은 arena 로, 오래된 Command 가 버려지는 것을 보여줍니다.
+    CommandHistory history(4 * sizeof(ChangeWebPageCommand), 16);
+
+    history.Execute(ChangeWebPageCommand(webPageManager, "http://taeguk.me"));
+    history.Execute(ChangeWebPageCommand(webPageManager, "http://github.com/taeguk"));
+    history.Execute(ChangeWebPageCommand(webPageManager, "http://taeguk.me/about"));
+
+    std::cout << "---- Undo x2 ----" << std::endl;
+    history.Undo();
+    history.Undo();
+    std::cout << "---- Redo x1 ----" << std::endl;
+    history.Redo();
+
+    std::cout << "---- Execute (redo history is discarded) ----" << std::endl;
+    history.Execute(ChangeWebPageCommand(webPageManager, "http://taeguk.me/blog"));
+    history.Execute(ChangeWebPageCommand(webPageManager, "http://taeguk.me/projects"));
+    history.Execute(ChangeWebPageCommand(webPageManager, "http://taeguk.me/contact"));
+    std::cout << "undo " << history.GetUndoCount() << ", redo " << history.GetRedoCount()
+        << ", evicted " << history.GetEvictedCount() << std::endl;
+
+    std::cout << "---- Undo all ----" << std::endl;
+    while (history.Undo())
+    {}
+    std::cout << "Current web page : " << webPageManager.GetWebPage() << std::endl;
+
+    std::cout << "---- Benchmark (500,000 steps of history) ----" << std::endl;
+    Benchmark(500000);
+}
@@ -0,0 +1,466 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../AccessKey.h"
+
+class EstateOwner;
+class GroceryStore;
+class Restaurant;
+
+////////////////////////////////////////////////////////////////////////////////
+/*
+    GroceryStore 의 재고는 여러 thread 에서 동시에 Sell 과 Supply 할 수 있습니다.
+    GroceryStockChanged 는 재고가 있음 <-> 없음 으로 바뀔 때만 불리며, 여러 thread 에서 동시에 불릴 수 있습니다.
+    (EstateOwner 와 가격 변경은 기존처럼 하나의 thread 에서만 사용한다고 가정합니다.)
+    여러 개의 음식을 한 번에 사는 경우에는 FoodsAreCooked 로 한 번만 알립니다.
+*/
+class BusinessMediator
+{
+public:
+    BusinessMediator(EstateOwner& estateOwner, GroceryStore& groceryStore, Restaurant& restaurant);
+
+    void EstateRentPriceChanged(std::int32_t oldPrice, std::int32_t newPrice);
+    void GroceryStockChanged(std::int32_t currentStock);
+    void GroceryPriceChanged(std::int32_t oldPrice, std::int32_t newPrice);
+    void FoodIsCooked();
+    // count 개의 재료를 한 번에 사고, 실제로 산 개수를 반환합니다. (재고가 모자라도 예외를 던지지 않습니다.)
+    std::int32_t FoodsAreCooked(std::int32_t count);
+
+    std::uint64_t GetStockNotificationCount() const { return stockNotificationCount_.load(); }
+
+private:
+    EstateOwner& estateOwner_;
+    GroceryStore& groceryStore_;
+    Restaurant& restaurant_;
+    std::atomic<std::uint64_t> stockNotificationCount_{ 0 };
+};
+
+////////////////////////////////////////////////////////////////////////////////
+class EstateOwner
+{
+public:
+    std::int32_t SetEstateRentPrice(std::int32_t price)
+    {
+        auto oldPrice = estateRentPrice_;
+        estateRentPrice_ = price;
+        if (mediator_) mediator_->EstateRentPriceChanged(oldPrice, price);
+        return oldPrice;
+    }
+
+    BusinessMediator* SetBusinessMediator(design::AccessKey<BusinessMediator>,
+                                          BusinessMediator* mediator)
+    {
+        BusinessMediator* old = mediator_;
+        mediator_ = mediator;
+        return old;
+    }
+
+private:
+    BusinessMediator* mediator_{ nullptr };
+    std::int32_t estateRentPrice_{ 10000 };
+};
+
+////////////////////////////////////////////////////////////////////////////////
+class GroceryStore
+{
+public:
+    std::int32_t Supply(std::uint16_t count)
+    {
+        auto oldStock = stock_.fetch_add(count);
+        if (oldStock <= 0 && count > 0)
+        {
+            NotifyStockEdge_();
+        }
+        return oldStock + count;
+    }
+
+    std::int32_t Sell()
+    {
+        if (TrySell(1) == 0)
+        {
+            throw std::logic_error("Not in stock.");
+        }
+        return price_.load(std::memory_order_relaxed);
+    }
+
+    /*
+        count 개까지 한 번의 CAS 로 팔고, 실제로 판 개수를 반환합니다. 재고가 모자라면 남은 만큼만 팔고,
+        재고가 없으면 0 을 반환합니다. 예외를 던지지 않습니다.
+        재고가 남아있을 때만 줄어들도록 CAS 로 확인하므로, 재고가 음수가 되지 않습니다.
+    */
+    std::int32_t TrySell(std::int32_t count)
+    {
+        auto stock = stock_.load();
+        std::int32_t soldCount;
+        do
+        {
+            soldCount = std::min(stock, count);
+            if (soldCount <= 0)
+            {
+                return 0;
+            }
+        } while (!stock_.compare_exchange_weak(stock, stock - soldCount));
+
+        if (stock == soldCount)
+        {
+            NotifyStockEdge_();
+        }
+        return soldCount;
+    }
+
+    std::int32_t AlterPrice(std::int32_t priceChange)
+    {
+        auto oldPrice = price_.fetch_add(priceChange, std::memory_order_relaxed);
+        if (mediator_) mediator_->GroceryPriceChanged(oldPrice, oldPrice + priceChange);
+        return oldPrice + priceChange;
+    }
+
+    std::int32_t GetStock() const { return stock_.load(); }
+
+    BusinessMediator* SetBusinessMediator(design::AccessKey<BusinessMediator>,
+                                          BusinessMediator* mediator)
+    {
+        BusinessMediator* old = mediator_;
+        mediator_ = mediator;
+        return old;
+    }
+
+private:
+    /*
+        재고가 0 을 지나갈 때 불립니다.
+        두 thread 가 거의 동시에 반대 방향으로 0 을 지나가면, 알림이 순서가 바뀌어 도착할 수 있습니다.
+        그래서 알린 뒤에 재고를 다시 읽어서, 알린 값과 있음/없음이 다르면 다시 알립니다.
+        마지막으로 알린 thread 는 알린 값과 실제 재고가 일치하는 것을 확인했으므로,
+        동시에 일어나던 변경들이 끝나면 Mediator 가 받은 마지막 알림은 항상 실제 재고와 일치합니다.
+    */
+    void NotifyStockEdge_()
+    {
+        if (!mediator_)
+        {
+            return;
+        }
+
+        std::int32_t stock;
+        do
+        {
+            stock = stock_.load();
+            mediator_->GroceryStockChanged(stock);
+        } while ((stock_.load() > 0) != (stock > 0));
+    }
+
+    BusinessMediator* mediator_{ nullptr };
+    std::atomic<std::int32_t> stock_{ 0 };
+    std::atomic<std::int32_t> price_{ 100 };
+};
+
+////////////////////////////////////////////////////////////////////////////////
+class Restaurant
+{
+public:
+    struct PurchaseResult
+    {
+        std::int32_t fulfilledCount;
+        std::int64_t totalPrice;
+    };
+
+    // 영업 중인 것을 확인한 사이에 다른 thread 가 마지막 재고를 사갈 수 있으므로, 그 경우에도 -1 을 반환합니다.
+    std::int32_t CookFood()
+    {
+        auto result = TryBuy(1);
+        if (result.fulfilledCount > 0)
+        {
+            return static_cast<std::int32_t>(result.totalPrice);
+        }
+        else
+        {
+            return -1;
+        }
+    }
+
+    // count 개의 음식을 한 번에 만듭니다. 재고가 모자라면 만들 수 있는 만큼만 만들고, 예외를 던지지 않습니다.
+    PurchaseResult TryBuy(std::int32_t count)
+    {
+        if (count <= 0 || !isOpened_.load())
+        {
+            return { 0, 0 };
+        }
+
+        auto fulfilledCount = mediator_ ? mediator_->FoodsAreCooked(count) : count;
+        return { fulfilledCount, static_cast<std::int64_t>(fulfilledCount) * price_.load(std::memory_order_relaxed) };
+    }
+
+    std::int32_t AlterPrice(std::int32_t priceChange)
+    {
+        return price_.fetch_add(priceChange, std::memory_order_relaxed) + priceChange;
+    }
+
+    bool IsOpened() const { return isOpened_.load(); }
+
+    BusinessMediator* SetBusinessMediator(design::AccessKey<BusinessMediator>,
+                                          BusinessMediator* mediator)
+    {
+        BusinessMediator* old = mediator_;
+        mediator_ = mediator;
+        return old;
+    }
+
+    void SetIsOpened(design::AccessKey<BusinessMediator>,
+                     bool isOpened)
+    {
+        isOpened_.store(isOpened);
+    }
+
+private:
+    BusinessMediator* mediator_{ nullptr };
+    std::atomic<bool> isOpened_{ true };
+    std::atomic<std::int32_t> price_{ 500 };
+};
+
+////////////////////////////////////////////////////////////////////////////////
+BusinessMediator::BusinessMediator(EstateOwner& estateOwner, GroceryStore& groceryStore, Restaurant& restaurant)
+    : estateOwner_(estateOwner), groceryStore_(groceryStore), restaurant_(restaurant)
+{
+    estateOwner_.SetBusinessMediator(design::AccessKey<BusinessMediator>(), this);
+    groceryStore_.SetBusinessMediator(design::AccessKey<BusinessMediator>(), this);
+    restaurant_.SetBusinessMediator(design::AccessKey<BusinessMediator>(), this);
+}
+
+void BusinessMediator::EstateRentPriceChanged(std::int32_t oldPrice, std::int32_t newPrice)
+{
+    groceryStore_.AlterPrice((newPrice - oldPrice) / 10000);
+    restaurant_.AlterPrice((newPrice - oldPrice) / 1000);
+}
+
+void BusinessMediator::GroceryStockChanged(std::int32_t currentStock)
+{
+    stockNotificationCount_.fetch_add(1, std::memory_order_relaxed);
+    if (currentStock > 0)
+    {
+        restaurant_.SetIsOpened(design::AccessKey<BusinessMediator>(), true);
+    }
+    else
+    {
+        restaurant_.SetIsOpened(design::AccessKey<BusinessMediator>(), false);
+    }
+}
+
+void BusinessMediator::GroceryPriceChanged(std::int32_t oldPrice, std::int32_t newPrice)
+{
+    restaurant_.AlterPrice(newPrice - oldPrice);
+}
+
+void BusinessMediator::FoodIsCooked()
+{
+    groceryStore_.Sell();
+}
+
+std::int32_t BusinessMediator::FoodsAreCooked(std::int32_t count)
+{
+    return groceryStore_.TrySell(count);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void BuyFood(Restaurant& restaurant)
+{
+    auto price = restaurant.CookFood();
+    if (price >= 0)
+    {
+        std::cout << "[BuyFood] The price of food : " << price << std::endl;
+    }
+    else
+    {
+        std::cout << "[BuyFood] Restaurant was closed bescause groceries are lack." << std::endl;
+    }
+}
+
+void BuyFood(Restaurant& restaurant, std::int32_t count)
+{
+    auto result = restaurant.TryBuy(count);
+    if (result.fulfilledCount > 0)
+    {
+        std::cout << "[BuyFood] " << result.fulfilledCount << " / " << count
+            << " foods, total price : " << result.totalPrice << std::endl;
+    }
+    else
+    {
+        std::cout << "[BuyFood] Restaurant was closed bescause groceries are lack." << std::endl;
+    }
+}
+
+void SupplyGrocery(GroceryStore& groceryStore, std::uint16_t count)
+{
+    auto newCount = groceryStore.Supply(count);
+    auto oldCount = newCount - count;
+    std::cout << "Grocery Stock Changes : " << oldCount << " -> " << newCount << std::endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Load Test : 여러 thread 가 동시에 음식을 사고, 식료품을 공급합니다.
+//             구매자들은 공급이 모두 끝나고 재고가 바닥날 때까지 계속 삽니다.
+
+bool RunLoadTest(std::size_t buyerCount, std::size_t supplierCount,
+                 std::size_t suppliesPerSupplier, std::int32_t buyBatchSize = 1)
+{
+    EstateOwner estateOwner;
+    GroceryStore groceryStore;
+    Restaurant restaurant;
+    BusinessMediator mediator(estateOwner, groceryStore, restaurant);
+
+    std::atomic<std::uint64_t> buyCount{ 0 };
+    std::atomic<std::uint64_t> soldCount{ 0 };
+    std::atomic<std::uint64_t> rejectedCount{ 0 };
+    std::atomic<std::size_t> runningSupplierCount{ supplierCount };
+    std::atomic<std::uint64_t> suppliedCount{ 0 };
+    std::atomic<bool> isOversold{ false };
+
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+
+    for (std::size_t i = 0; i < buyerCount; ++i)
+    {
+        threads.emplace_back([&]
+        {
+            std::uint64_t buys = 0;
+            std::uint64_t sold = 0;
+            std::uint64_t rejected = 0;
+            for (;;)
+            {
+                auto isSupplyFinished = runningSupplierCount.load() == 0;
+                auto fulfilledCount = restaurant.TryBuy(buyBatchSize).fulfilledCount;
+                ++buys;
+                sold += fulfilledCount;
+                rejected += buyBatchSize - fulfilledCount;
+
+                if (groceryStore.GetStock() < 0)
+                    isOversold.store(true);
+                if (fulfilledCount == 0 && isSupplyFinished)
+                    break;
+            }
+            buyCount += buys;
+            soldCount += sold;
+            rejectedCount += rejected;
+        });
+    }
+
+    for (std::size_t i = 0; i < supplierCount; ++i)
+    {
+        threads.emplace_back([&, i]
+        {
+            std::uint64_t supplied = 0;
+            for (std::size_t n = 0; n < suppliesPerSupplier; ++n)
+            {
+                auto count = static_cast<std::uint16_t>(1 + (n + i) % 4);
+                groceryStore.Supply(count);
+                supplied += count;
+            }
+            suppliedCount += supplied;
+            --runningSupplierCount;
+        });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    auto stock = groceryStore.GetStock();
+    auto operationCount = buyCount.load() + supplierCount * suppliesPerSupplier;
+
+    // 공급된 만큼 정확히 팔렸어야 하고, 재고가 음수가 된 적이 없어야 하며, 영업 여부는 재고와 일치해야 합니다.
+    bool isPassed = !isOversold.load()
+        && stock == 0
+        && soldCount.load() == suppliedCount.load()
+        && restaurant.IsOpened() == (stock > 0);
+
+    std::cout << buyerCount << " buyers (batch " << buyBatchSize << "), " << supplierCount << " suppliers : "
+        << static_cast<std::uint64_t>(operationCount / elapsed) << " ops/s, sold " << soldCount.load()
+        << ", rejected " << rejectedCount.load() << ", supplied " << suppliedCount.load()
+        << ", final stock " << stock << ", stock notifications " << mediator.GetStockNotificationCount()
+        << " / " << operationCount << " ops -> " << (isPassed ? "passed" : "FAILED") << std::endl;
+    return isPassed;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Benchmark : 재고가 자주 바닥나는 상황에서, 하나씩 사면서 예외를 잡는 방법과 TryBuy 를 비교합니다.
+
+void Benchmark(std::size_t roundCount, std::int32_t buyCount, std::uint16_t supplyCount)
+{
+    EstateOwner estateOwner;
+    GroceryStore groceryStore;
+    Restaurant restaurant;
+    BusinessMediator mediator(estateOwner, groceryStore, restaurant);
+
+    std::int64_t soldCount = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t round = 0; round < roundCount; ++round)
+    {
+        groceryStore.Supply(supplyCount);
+        for (std::int32_t i = 0; i < buyCount; ++i)
+        {
+            try
+            {
+                groceryStore.Sell();
+                ++soldCount;
+            }
+            catch (std::logic_error const&)
+            {
+            }
+        }
+    }
+    auto throwingTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::int64_t batchSoldCount = 0;
+    start = std::chrono::steady_clock::now();
+    for (std::size_t round = 0; round < roundCount; ++round)
+    {
+        groceryStore.Supply(supplyCount);
+        batchSoldCount += restaurant.TryBuy(buyCount).fulfilledCount;
+    }
+    auto batchTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "buy " << buyCount << " with " << supplyCount << " in stock : Sell + catch " << throwingTime
+        << " ms, TryBuy " << batchTime << " ms (sold " << soldCount << " / " << batchSoldCount << ")" << std::endl;
+}
+
+int main()
+{
+    EstateOwner estateOwner;
+    GroceryStore groceryStore;
+    Restaurant restaurant;
+
+    BusinessMediator mediator(estateOwner, groceryStore, restaurant);
+
+    SupplyGrocery(groceryStore, 2);
+    groceryStore.Sell();
+    BuyFood(restaurant);
+    BuyFood(restaurant);
+    SupplyGrocery(groceryStore, 3);
+    BuyFood(restaurant);
+    SupplyGrocery(groceryStore, 3);
+    BuyFood(restaurant, 5);
+    BuyFood(restaurant, 5);
+    std::cout << "Stock notifications : " << mediator.GetStockNotificationCount() << std::endl;
+    std::cout << std::endl;
+
+    auto threadCount = std::max(2u, std::thread::hardware_concurrency());
+    std::cout << "---- Load Test ----" << std::endl;
+    RunLoadTest(threadCount / 2, threadCount - threadCount / 2, 300000);
+    RunLoadTest(threadCount, 1, 1000000);
+    RunLoadTest(threadCount, 1, 1000000, 16);
+    std::cout << std::endl;
+
+    std::cout << "---- Benchmark (100,000 rounds) ----" << std::endl;
+    Benchmark(100000, 16, 4);
+    Benchmark(100000, 16, 12);
+}
@@ -0,0 +1,504 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../../AccessKey.h"
+
+class EstateOwner;
+class GroceryStore;
+class Restaurant;
+
+////////////////////////////////////////////////////////////////////////////////
+/*
+    Immediate 모드에서는 기존처럼 알림을 받는 즉시 다른 객체들에게 전파합니다.
+    이 경우 EstateOwner 의 가격 변경 한 번이 GroceryStore::AlterPrice 를 거쳐
+    다시 Mediator 로 돌아오는 재귀적인 연쇄 호출을 일으킵니다.
+
+    Deferred 모드에서는 가격 변경 알림을 event queue 에 쌓아두기만 하고, Drain 할 때 한꺼번에 처리합니다.
+    같은 종류(= 보낸 객체)의 event 는 아직 전파되지 않은 변경에 합쳐지므로, queue 에는 종류마다
+    많아야 하나의 event 만 남습니다.
+      - 가격 변경은 다른 객체들에게 전파할 변화량을 알림마다 계산해서 (정수 나눗셈도 알림마다 합니다) 더해두므로,
+        여러 번의 변경이 한 번의 재계산이 되면서도 Immediate 모드와 같은 결과가 됩니다.
+    전파하면서 새로 생긴 event 들은 다음 round 에서 처리되므로, 호출 깊이가 깊어지지 않습니다.
+    재고 변경은 Restaurant 의 영업 여부만 바꾸고 더 전파되지 않으므로, 미루지 않고 바로 적용합니다.
+    따라서 한 batch 안에서 재고가 바닥나면 Restaurant 는 바로 문을 닫고, Immediate 모드처럼 CookFood 가 -1 을 반환합니다.
+    FoodIsCooked 는 판매 그 자체이므로 미루지 않고 바로 GroceryStore::Sell 을 호출합니다.
+*/
+class BusinessMediator
+{
+public:
+    enum class Mode
+    {
+        Immediate,
+        Deferred
+    };
+
+    struct Statistics
+    {
+        std::uint64_t postedEvents{ 0 };
+        std::uint64_t coalescedEvents{ 0 };     //< 다른 event 와 합쳐져서 따로 전파되지 않은 event 수
+        std::uint64_t fanOuts{ 0 };             //< 실제로 다른 객체들에게 전파한 횟수
+        std::uint32_t maxDepth{ 0 };            //< Mediator 안으로 재진입한 최대 깊이
+    };
+
+    BusinessMediator(EstateOwner& estateOwner, GroceryStore& groceryStore, Restaurant& restaurant,
+                     Mode mode = Mode::Immediate);
+
+    void EstateRentPriceChanged(std::int32_t oldPrice, std::int32_t newPrice);
+    void GroceryStockChanged(std::int32_t currentStock);
+    void GroceryPriceChanged(std::int32_t oldPrice, std::int32_t newPrice);
+    void FoodIsCooked();
+
+    // 쌓여있는 event 들을 더 이상 남지 않을 때까지 처리합니다. (Immediate 모드에서는 아무 일도 하지 않습니다.)
+    void Drain();
+
+    Mode GetMode() const { return mode_; }
+    Statistics const& GetStatistics() const { return statistics_; }
+
+private:
+    enum class EventType_ : std::uint8_t
+    {
+        EstateRentPriceChanged,
+        GroceryPriceChanged,
+        Count
+    };
+
+    // 한 번의 가격 변경이 다른 객체들에게 전파할 가격 변화량.
+    struct PriceChange_
+    {
+        std::int32_t groceryPrice{ 0 };
+        std::int32_t restaurantPrice{ 0 };
+    };
+
+    // 아직 전파되지 않은, 같은 종류의 event 들의 변화량을 합쳐놓는 곳.
+    struct PendingChange_
+    {
+        bool isSet{ false };
+        PriceChange_ change;
+    };
+
+    // 기존 Mediator 의 전파 규칙들입니다. 두 모드가 같은 규칙을 공유합니다.
+    static PriceChange_ GetEstateRentPriceChange_(std::int32_t oldPrice, std::int32_t newPrice);
+    static PriceChange_ GetGroceryPriceChange_(std::int32_t oldPrice, std::int32_t newPrice);
+    void ApplyEstateRentPriceChanged_(PriceChange_ const& change);
+    void ApplyGroceryStockChanged_(std::int32_t currentStock);
+    void ApplyGroceryPriceChanged_(PriceChange_ const& change);
+
+    void Post_(EventType_ type, PriceChange_ const& change);
+
+    class DepthGuard_
+    {
+    public:
+        explicit DepthGuard_(BusinessMediator& mediator)
+            : mediator_(mediator)
+        {
+            ++mediator_.depth_;
+            mediator_.statistics_.maxDepth = std::max(mediator_.statistics_.maxDepth, mediator_.depth_);
+        }
+
+        ~DepthGuard_() { --mediator_.depth_; }
+
+    private:
+        BusinessMediator& mediator_;
+    };
+
+    EstateOwner& estateOwner_;
+    GroceryStore& groceryStore_;
+    Restaurant& restaurant_;
+    Mode mode_;
+
+    // 합쳐진 변경이 처음 생긴 순서대로, 종류만 queue 에 쌓습니다.
+    PendingChange_ pendings_[static_cast<std::size_t>(EventType_::Count)];
+    std::vector<EventType_> events_;
+    std::vector<EventType_> draining_;
+    std::uint32_t depth_{ 0 };
+    Statistics statistics_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+class EstateOwner
+{
+public:
+    std::int32_t SetEstateRentPrice(std::int32_t price)
+    {
+        auto oldPrice = estateRentPrice_;
+        estateRentPrice_ = price;
+        if (mediator_) mediator_->EstateRentPriceChanged(oldPrice, price);
+        return oldPrice;
+    }
+
+    BusinessMediator* SetBusinessMediator(design::AccessKey<BusinessMediator>,
+                                          BusinessMediator* mediator)
+    {
+        BusinessMediator* old = mediator_;
+        mediator_ = mediator;
+        return old;
+    }
+
+private:
+    BusinessMediator* mediator_{ nullptr };
+    std::int32_t estateRentPrice_{ 10000 };
+};
+
+////////////////////////////////////////////////////////////////////////////////
+class GroceryStore
+{
+public:
+    std::int32_t Supply(std::uint16_t count)
+    {
+        stock_ += count;
+        if (mediator_) mediator_->GroceryStockChanged(stock_);
+        return stock_;
+    }
+
+    std::int32_t Sell()
+    {
+        if (stock_ <= 0)
+        {
+            throw std::logic_error("Not in stock.");
+        }
+
+        --stock_;
+        if (mediator_) mediator_->GroceryStockChanged(stock_);
+        return price_;
+    }
+
+    std::int32_t AlterPrice(std::int32_t priceChange)
+    {
+        auto oldPrice = price_;
+        price_ += priceChange;
+        if (mediator_) mediator_->GroceryPriceChanged(oldPrice, price_);
+        return price_;
+    }
+
+    std::int32_t GetPrice() const { return price_; }
+    std::int32_t GetStock() const { return stock_; }
+
+    BusinessMediator* SetBusinessMediator(design::AccessKey<BusinessMediator>,
+                                          BusinessMediator* mediator)
+    {
+        BusinessMediator* old = mediator_;
+        mediator_ = mediator;
+        return old;
+    }
+
+private:
+    BusinessMediator* mediator_{ nullptr };
+    std::int32_t stock_{ 0 };
+    std::int32_t price_{ 100 };
+};
+
+////////////////////////////////////////////////////////////////////////////////
+class Restaurant
+{
+public:
+    std::int32_t CookFood()
+    {
+        if (isOpened_)
+        {
+            if (mediator_) mediator_->FoodIsCooked();
+            return price_;
+        }
+        else
+        {
+            return -1;
+        }
+    }
+
+    std::int32_t AlterPrice(std::int32_t priceChange)
+    {
+        price_ += priceChange;
+        return price_;
+    }
+
+    std::int32_t GetPrice() const { return price_; }
+
+    BusinessMediator* SetBusinessMediator(design::AccessKey<BusinessMediator>,
+                                          BusinessMediator* mediator)
+    {
+        BusinessMediator* old = mediator_;
+        mediator_ = mediator;
+        return old;
+    }
+
+    void SetIsOpened(design::AccessKey<BusinessMediator>,
+                     bool isOpened)
+    {
+        isOpened_ = isOpened;
+    }
+
+private:
+    BusinessMediator* mediator_{ nullptr };
+    bool isOpened_{ true };
+    std::int32_t price_{ 500 };
+};
+
+////////////////////////////////////////////////////////////////////////////////
+BusinessMediator::BusinessMediator(EstateOwner& estateOwner, GroceryStore& groceryStore, Restaurant& restaurant,
+                                   Mode mode)
+    : estateOwner_(estateOwner), groceryStore_(groceryStore), restaurant_(restaurant), mode_(mode)
+{
+    estateOwner_.SetBusinessMediator(design::AccessKey<BusinessMediator>(), this);
+    groceryStore_.SetBusinessMediator(design::AccessKey<BusinessMediator>(), this);
+    restaurant_.SetBusinessMediator(design::AccessKey<BusinessMediator>(), this);
+}
+
+void BusinessMediator::EstateRentPriceChanged(std::int32_t oldPrice, std::int32_t newPrice)
+{
+    auto change = GetEstateRentPriceChange_(oldPrice, newPrice);
+    if (mode_ == Mode::Deferred)
+        Post_(EventType_::EstateRentPriceChanged, change);
+    else
+        ApplyEstateRentPriceChanged_(change);
+}
+
+// 두 모드 모두 바로 적용합니다.
+void BusinessMediator::GroceryStockChanged(std::int32_t currentStock)
+{
+    ApplyGroceryStockChanged_(currentStock);
+}
+
+void BusinessMediator::GroceryPriceChanged(std::int32_t oldPrice, std::int32_t newPrice)
+{
+    auto change = GetGroceryPriceChange_(oldPrice, newPrice);
+    if (mode_ == Mode::Deferred)
+        Post_(EventType_::GroceryPriceChanged, change);
+    else
+        ApplyGroceryPriceChanged_(change);
+}
+
+void BusinessMediator::FoodIsCooked()
+{
+    DepthGuard_ guard(*this);
+    groceryStore_.Sell();
+}
+
+void BusinessMediator::Drain()
+{
+    DepthGuard_ guard(*this);
+
+    while (!events_.empty())
+    {
+        draining_.clear();
+        draining_.swap(events_);
+
+        // 여기서 생기는 event 들은 events_ 에 쌓여서, 다음 round 에 처리됩니다.
+        // (아직 처리되지 않은 종류의 event 라면, 그 변경에 합쳐집니다.)
+        for (auto type : draining_)
+        {
+            auto& pending = pendings_[static_cast<std::size_t>(type)];
+            auto change = pending.change;
+            pending = PendingChange_();
+
+            if (change.groceryPrice == 0 && change.restaurantPrice == 0)
+            {
+                continue;
+            }
+
+            switch (type)
+            {
+            case EventType_::EstateRentPriceChanged:
+                ApplyEstateRentPriceChanged_(change);
+                break;
+            case EventType_::GroceryPriceChanged:
+                ApplyGroceryPriceChanged_(change);
+                break;
+            case EventType_::Count:
+                break;
+            }
+        }
+    }
+}
+
+BusinessMediator::PriceChange_ BusinessMediator::GetEstateRentPriceChange_(std::int32_t oldPrice, std::int32_t newPrice)
+{
+    PriceChange_ change;
+    change.groceryPrice = (newPrice - oldPrice) / 10000;
+    change.restaurantPrice = (newPrice - oldPrice) / 1000;
+    return change;
+}
+
+BusinessMediator::PriceChange_ BusinessMediator::GetGroceryPriceChange_(std::int32_t oldPrice, std::int32_t newPrice)
+{
+    PriceChange_ change;
+    change.restaurantPrice = newPrice - oldPrice;
+    return change;
+}
+
+void BusinessMediator::ApplyEstateRentPriceChanged_(PriceChange_ const& change)
+{
+    DepthGuard_ guard(*this);
+    ++statistics_.fanOuts;
+    groceryStore_.AlterPrice(change.groceryPrice);
+    restaurant_.AlterPrice(change.restaurantPrice);
+}
+
+void BusinessMediator::ApplyGroceryStockChanged_(std::int32_t currentStock)
+{
+    DepthGuard_ guard(*this);
+    ++statistics_.fanOuts;
+    if (currentStock > 0)
+    {
+        restaurant_.SetIsOpened(design::AccessKey<BusinessMediator>(), true);
+    }
+    else
+    {
+        restaurant_.SetIsOpened(design::AccessKey<BusinessMediator>(), false);
+    }
+}
+
+void BusinessMediator::ApplyGroceryPriceChanged_(PriceChange_ const& change)
+{
+    DepthGuard_ guard(*this);
+    ++statistics_.fanOuts;
+    restaurant_.AlterPrice(change.restaurantPrice);
+}
+
+void BusinessMediator::Post_(EventType_ type, PriceChange_ const& change)
+{
+    ++statistics_.postedEvents;
+
+    auto& pending = pendings_[static_cast<std::size_t>(type)];
+    if (pending.isSet)
+    {
+        ++statistics_.coalescedEvents;
+    }
+    else
+    {
+        pending.isSet = true;
+        events_.push_back(type);
+    }
+    pending.change.groceryPrice += change.groceryPrice;
+    pending.change.restaurantPrice += change.restaurantPrice;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void BuyFood(Restaurant& restaurant)
+{
+    auto price = restaurant.CookFood();
+    if (price >= 0)
+    {
+        std::cout << "[BuyFood] The price of food : " << price << std::endl;
+    }
+    else
+    {
+        std::cout << "[BuyFood] Restaurant was closed bescause groceries are lack." << std::endl;
+    }
+}
+
+void SupplyGrocery(GroceryStore& groceryStore, std::uint16_t count)
+{
+    auto newCount = groceryStore.Supply(count);
+    auto oldCount = newCount - count;
+    std::cout << "Grocery Stock Changes : " << oldCount << " -> " << newCount << std::endl;
+}
+
+void ChangeGroceryPrice(GroceryStore& groceryStore, std::int32_t priceChange)
+{
+    auto newPrice = groceryStore.AlterPrice(priceChange);
+    auto oldPrice = newPrice - priceChange;
+    std::cout << "Grocery Price Changes : " << oldPrice << " -> " << newPrice << std::endl;
+}
+
+void ChangeEstateRentPrice(EstateOwner& estateOwner, std::int32_t newPrice)
+{
+    auto oldPrice = estateOwner.SetEstateRentPrice(newPrice);
+    std::cout << "EstateRentPrice Changes : " << oldPrice << " -> " << newPrice << std::endl;
+}
+
+void PrintStatistics(BusinessMediator const& mediator)
+{
+    auto const& statistics = mediator.GetStatistics();
+    std::cout << "posted " << statistics.postedEvents << ", coalesced " << statistics.coalescedEvents
+        << ", fan-outs " << statistics.fanOuts << ", max depth " << statistics.maxDepth << std::endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Benchmark : 임대료와 식료품 가격이 짧은 시간에 몰아서 바뀌는 상황을 흉내냅니다.
+//             중간중간 요리를 하고 식료품을 공급해서, batch 안에서 재고가 바닥나는 경우도 섞습니다.
+
+struct EndState
+{
+    std::int32_t groceryPrice;
+    std::int32_t restaurantPrice;
+    std::int32_t groceryStock;
+};
+
+EndState Benchmark(BusinessMediator::Mode mode, std::size_t updateCount, std::size_t batchSize)
+{
+    EstateOwner estateOwner;
+    GroceryStore groceryStore;
+    Restaurant restaurant;
+    BusinessMediator mediator(estateOwner, groceryStore, restaurant, mode);
+
+    std::mt19937 random(42);
+    std::uniform_int_distribution<std::int32_t> rentPrice(5000, 500000);
+    std::uniform_int_distribution<std::int32_t> priceChange(-5, 5);
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < updateCount; ++i)
+    {
+        if (i % 2 == 0)
+            estateOwner.SetEstateRentPrice(rentPrice(random));
+        else
+            groceryStore.AlterPrice(priceChange(random));
+
+        if (i % 50 == 0)
+            groceryStore.Supply(5);
+        if (i % 7 == 0)
+            restaurant.CookFood();
+
+        if ((i + 1) % batchSize == 0)
+            mediator.Drain();
+    }
+    mediator.Drain();
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << (mode == BusinessMediator::Mode::Deferred ? "deferred " : "immediate")
+        << " : " << elapsed << " ms, restaurant price " << restaurant.GetPrice() << ", stock " << groceryStore.GetStock() << ", ";
+    PrintStatistics(mediator);
+    return { groceryStore.GetPrice(), restaurant.GetPrice(), groceryStore.GetStock() };
+}
+
+int main()
+{
+    EstateOwner estateOwner;
+    GroceryStore groceryStore;
+    Restaurant restaurant;
+
+    BusinessMediator mediator(estateOwner, groceryStore, restaurant, BusinessMediator::Mode::Deferred);
+
+    SupplyGrocery(groceryStore, 2);
+    groceryStore.Sell();
+    mediator.Drain();
+    BuyFood(restaurant);
+    mediator.Drain();
+    BuyFood(restaurant);
+    std::cout << std::endl;
+
+    // 여러 번의 변경이 쌓인 뒤 한 번에 전파됩니다.
+    SupplyGrocery(groceryStore, 3);
+    ChangeEstateRentPrice(estateOwner, 1000);
+    ChangeEstateRentPrice(estateOwner, 100000);
+    ChangeGroceryPrice(groceryStore, 100);
+    ChangeGroceryPrice(groceryStore, -50);
+    mediator.Drain();
+    BuyFood(restaurant);
+    PrintStatistics(mediator);
+    std::cout << std::endl;
+
+    std::cout << "---- Benchmark (1,000,000 updates, drain every 1,000) ----" << std::endl;
+    auto immediate = Benchmark(BusinessMediator::Mode::Immediate, 1000000, 1000);
+    auto deferred = Benchmark(BusinessMediator::Mode::Deferred, 1000000, 1000);
+    std::cout << "(same end state : " << std::boolalpha
+        << (immediate.groceryPrice == deferred.groceryPrice && immediate.restaurantPrice == deferred.restaurantPrice
+            && immediate.groceryStock == deferred.groceryStock) << ")" << std::endl;
+}
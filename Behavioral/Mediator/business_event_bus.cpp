@@ -0,0 +1,724 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <typeindex>
+#include <utility>
+#include <vector>
+
+#include "../../AccessKey.h"
+
+////////////////////////////////////////////////////////////////////////////////
+/*
+    Event 의 type 으로 handler 를 찾는 범용 Mediator 입니다.
+    handler 들은 template 인자로 등록되고, Publish<Event> 는 compile time 에
+    Handle(Event const&) 를 가진 handler 들만 골라서 등록된 순서대로 직접 호출합니다.
+    (std::map 의 검색도, std::function 도, 가상 함수 호출도 없으므로 모두 inline 될 수 있습니다.)
+    처리하는 handler 가 하나도 없는 Event 를 Publish 하면 compile error 가 납니다.
+
+    Publish 는 AccessKey<Key> 를 가진 쪽에서만 얻을 수 있는 Publisher 를 통해서만 할 수 있습니다.
+*/
+template <typename Key, typename... Handlers>
+class EventBus
+{
+public:
+    class Publisher
+    {
+    public:
+        Publisher() = default;
+
+        template <typename Event>
+        void Publish(Event const& event) const
+        {
+            if (bus_) bus_->Publish_(event);
+        }
+
+    private:
+        friend EventBus;
+
+        explicit Publisher(EventBus* bus)
+            : bus_(bus)
+        {}
+
+        EventBus* bus_{ nullptr };
+    };
+
+    explicit EventBus(Handlers&... handlers)
+        : handlers_(handlers...)
+    {}
+
+    EventBus(EventBus const&) = delete;
+    EventBus& operator=(EventBus const&) = delete;
+
+    Publisher GetPublisher(design::AccessKey<Key>)
+    {
+        return Publisher(this);
+    }
+
+    template <typename Event>
+    void Publish(design::AccessKey<Key>, Event const& event)
+    {
+        Publish_(event);
+    }
+
+private:
+    template <typename Handler, typename Event, typename = void>
+    struct CanHandle_ : std::false_type {};
+
+    template <typename Handler, typename Event>
+    struct CanHandle_<Handler, Event, decltype(std::declval<Handler&>().Handle(std::declval<Event const&>()), void())>
+        : std::true_type {};
+
+    template <typename Event>
+    static constexpr bool IsHandled_()
+    {
+        bool canHandles[] = { false, CanHandle_<Handlers, Event>::value... };
+        for (auto canHandle : canHandles)
+        {
+            if (canHandle) return true;
+        }
+        return false;
+    }
+
+    template <typename Event>
+    void Publish_(Event const& event)
+    {
+        static_assert(IsHandled_<Event>(), "There is no handler for the event.");
+        PublishTo_(event, std::index_sequence_for<Handlers...>());
+    }
+
+    template <typename Event, std::size_t... Indices>
+    void PublishTo_(Event const& event, std::index_sequence<Indices...>)
+    {
+        (void)std::initializer_list<int>{ (Dispatch_(std::get<Indices>(handlers_), event, 0), 0)... };
+    }
+
+    template <typename Handler, typename Event>
+    static auto Dispatch_(Handler& handler, Event const& event, int)
+        -> decltype(handler.Handle(event), void())
+    {
+        handler.Handle(event);
+    }
+
+    template <typename Handler, typename Event>
+    static void Dispatch_(Handler&, Event const&, long)
+    {}
+
+    std::tuple<Handlers&...> handlers_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// 기존 BusinessMediator 의 메소드 하나가 Event type 하나가 됩니다.
+
+struct EstateRentPriceChanged
+{
+    std::int32_t oldPrice;
+    std::int32_t newPrice;
+};
+
+struct GroceryStockChanged
+{
+    std::int32_t currentStock;
+};
+
+struct GroceryPriceChanged
+{
+    std::int32_t oldPrice;
+    std::int32_t newPrice;
+};
+
+struct FoodIsCooked
+{};
+
+class BusinessMediator;
+class BusinessRules;
+class PriceMonitor;
+class EstateOwner;
+class GroceryStore;
+class Restaurant;
+
+using BusinessEventBus = EventBus<BusinessMediator, BusinessRules, PriceMonitor>;
+
+////////////////////////////////////////////////////////////////////////////////
+class EstateOwner
+{
+public:
+    std::int32_t SetEstateRentPrice(std::int32_t price);
+
+    void SetPublisher(design::AccessKey<BusinessMediator>,
+                      BusinessEventBus::Publisher publisher)
+    {
+        publisher_ = publisher;
+    }
+
+private:
+    BusinessEventBus::Publisher publisher_;
+    std::int32_t estateRentPrice_{ 10000 };
+};
+
+////////////////////////////////////////////////////////////////////////////////
+class GroceryStore
+{
+public:
+    std::int32_t Supply(std::uint16_t count);
+    std::int32_t Sell();
+    std::int32_t AlterPrice(std::int32_t priceChange);
+
+    void SetPublisher(design::AccessKey<BusinessMediator>,
+                      BusinessEventBus::Publisher publisher)
+    {
+        publisher_ = publisher;
+    }
+
+private:
+    BusinessEventBus::Publisher publisher_;
+    std::int32_t stock_{ 0 };
+    std::int32_t price_{ 100 };
+};
+
+////////////////////////////////////////////////////////////////////////////////
+class Restaurant
+{
+public:
+    std::int32_t CookFood();
+
+    std::int32_t AlterPrice(std::int32_t priceChange)
+    {
+        price_ += priceChange;
+        return price_;
+    }
+
+    void SetPublisher(design::AccessKey<BusinessMediator>,
+                      BusinessEventBus::Publisher publisher)
+    {
+        publisher_ = publisher;
+    }
+
+    void SetIsOpened(design::AccessKey<BusinessMediator>,
+                     bool isOpened)
+    {
+        isOpened_ = isOpened;
+    }
+
+private:
+    BusinessEventBus::Publisher publisher_;
+    bool isOpened_{ true };
+    std::int32_t price_{ 500 };
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/*
+    기존 BusinessMediator 의 상호작용 로직입니다.
+    Restaurant::SetIsOpened 를 부르기 위해, BusinessMediator 가 건네준 AccessKey 를 가지고 있습니다.
+*/
+class BusinessRules
+{
+public:
+    BusinessRules(design::AccessKey<BusinessMediator> key,
+                  GroceryStore& groceryStore, Restaurant& restaurant)
+        : key_(key), groceryStore_(groceryStore), restaurant_(restaurant)
+    {}
+
+    void Handle(EstateRentPriceChanged const& event)
+    {
+        groceryStore_.AlterPrice((event.newPrice - event.oldPrice) / 10000);
+        restaurant_.AlterPrice((event.newPrice - event.oldPrice) / 1000);
+    }
+
+    void Handle(GroceryStockChanged const& event)
+    {
+        restaurant_.SetIsOpened(key_, event.currentStock > 0);
+    }
+
+    void Handle(GroceryPriceChanged const& event)
+    {
+        restaurant_.AlterPrice(event.newPrice - event.oldPrice);
+    }
+
+    void Handle(FoodIsCooked const&)
+    {
+        groceryStore_.Sell();
+    }
+
+private:
+    design::AccessKey<BusinessMediator> key_;
+    GroceryStore& groceryStore_;
+    Restaurant& restaurant_;
+};
+
+// 가격 변경만 구독하는 handler. (새로운 상호작용을 colleague 들을 고치지 않고 추가할 수 있습니다.)
+class PriceMonitor
+{
+public:
+    void Handle(EstateRentPriceChanged const&) { ++priceChangeCount_; }
+    void Handle(GroceryPriceChanged const&) { ++priceChangeCount_; }
+
+    std::uint64_t GetPriceChangeCount() const { return priceChangeCount_; }
+
+private:
+    std::uint64_t priceChangeCount_{ 0 };
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// BusinessMediator 는 handler 들과 EventBus 를 소유하고, colleague 들에게 Publisher 를 나누어 줍니다.
+class BusinessMediator
+{
+public:
+    BusinessMediator(EstateOwner& estateOwner, GroceryStore& groceryStore, Restaurant& restaurant)
+        : rules_(design::AccessKey<BusinessMediator>(), groceryStore, restaurant),
+          bus_(rules_, monitor_)
+    {
+        auto publisher = bus_.GetPublisher(design::AccessKey<BusinessMediator>());
+        estateOwner.SetPublisher(design::AccessKey<BusinessMediator>(), publisher);
+        groceryStore.SetPublisher(design::AccessKey<BusinessMediator>(), publisher);
+        restaurant.SetPublisher(design::AccessKey<BusinessMediator>(), publisher);
+    }
+
+    PriceMonitor const& GetPriceMonitor() const { return monitor_; }
+
+private:
+    BusinessRules rules_;
+    PriceMonitor monitor_;
+    BusinessEventBus bus_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Publish 하는 colleague 의 메소드들은 handler 들이 완전히 정의된 뒤에 정의합니다.
+// (class 안에서 정의한 메소드들처럼 inline 될 수 있도록 inline 으로 정의합니다.)
+
+inline std::int32_t EstateOwner::SetEstateRentPrice(std::int32_t price)
+{
+    auto oldPrice = estateRentPrice_;
+    estateRentPrice_ = price;
+    publisher_.Publish(EstateRentPriceChanged{ oldPrice, price });
+    return oldPrice;
+}
+
+inline std::int32_t GroceryStore::Supply(std::uint16_t count)
+{
+    stock_ += count;
+    publisher_.Publish(GroceryStockChanged{ stock_ });
+    return stock_;
+}
+
+inline std::int32_t GroceryStore::Sell()
+{
+    if (stock_ <= 0)
+    {
+        throw std::logic_error("Not in stock.");
+    }
+
+    --stock_;
+    publisher_.Publish(GroceryStockChanged{ stock_ });
+    return price_;
+}
+
+inline std::int32_t GroceryStore::AlterPrice(std::int32_t priceChange)
+{
+    auto oldPrice = price_;
+    price_ += priceChange;
+    publisher_.Publish(GroceryPriceChanged{ oldPrice, price_ });
+    return price_;
+}
+
+inline std::int32_t Restaurant::CookFood()
+{
+    if (isOpened_)
+    {
+        publisher_.Publish(FoodIsCooked{});
+        return price_;
+    }
+    else
+    {
+        return -1;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void BuyFood(Restaurant& restaurant)
+{
+    auto price = restaurant.CookFood();
+    if (price >= 0)
+    {
+        std::cout << "[BuyFood] The price of food : " << price << std::endl;
+    }
+    else
+    {
+        std::cout << "[BuyFood] Restaurant was closed bescause groceries are lack." << std::endl;
+    }
+}
+
+void SupplyGrocery(GroceryStore& groceryStore, std::uint16_t count)
+{
+    auto newCount = groceryStore.Supply(count);
+    auto oldCount = newCount - count;
+    std::cout << "Grocery Stock Changes : " << oldCount << " -> " << newCount << std::endl;
+}
+
+void ChangeGroceryPrice(GroceryStore& groceryStore, std::int32_t priceChange)
+{
+    auto newPrice = groceryStore.AlterPrice(priceChange);
+    auto oldPrice = newPrice - priceChange;
+    std::cout << "Grocery Price Changes : " << oldPrice << " -> " << newPrice << std::endl;
+}
+
+void ChangeEstateRentPrice(EstateOwner& estateOwner, std::int32_t newPrice)
+{
+    auto oldPrice = estateOwner.SetEstateRentPrice(newPrice);
+    std::cout << "EstateRentPrice Changes : " << oldPrice << " -> " << newPrice << std::endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Benchmark : 기존의 손으로 작성한 Mediator 와, std::function 으로 만든 event bus 와 비교합니다.
+
+namespace handwritten
+{
+
+class EstateOwner;
+class GroceryStore;
+class Restaurant;
+
+class BusinessMediator
+{
+public:
+    BusinessMediator(EstateOwner& estateOwner, GroceryStore& groceryStore, Restaurant& restaurant);
+
+    void EstateRentPriceChanged(std::int32_t oldPrice, std::int32_t newPrice);
+    void GroceryStockChanged(std::int32_t currentStock);
+    void GroceryPriceChanged(std::int32_t oldPrice, std::int32_t newPrice);
+    void FoodIsCooked();
+
+private:
+    GroceryStore& groceryStore_;
+    Restaurant& restaurant_;
+};
+
+class EstateOwner
+{
+public:
+    std::int32_t SetEstateRentPrice(std::int32_t price)
+    {
+        auto oldPrice = estateRentPrice_;
+        estateRentPrice_ = price;
+        if (mediator_) mediator_->EstateRentPriceChanged(oldPrice, price);
+        return oldPrice;
+    }
+
+    BusinessMediator* mediator_{ nullptr };
+    std::int32_t estateRentPrice_{ 10000 };
+};
+
+class GroceryStore
+{
+public:
+    std::int32_t Supply(std::uint16_t count)
+    {
+        stock_ += count;
+        if (mediator_) mediator_->GroceryStockChanged(stock_);
+        return stock_;
+    }
+
+    std::int32_t Sell()
+    {
+        if (stock_ <= 0)
+        {
+            throw std::logic_error("Not in stock.");
+        }
+
+        --stock_;
+        if (mediator_) mediator_->GroceryStockChanged(stock_);
+        return price_;
+    }
+
+    std::int32_t AlterPrice(std::int32_t priceChange)
+    {
+        auto oldPrice = price_;
+        price_ += priceChange;
+        if (mediator_) mediator_->GroceryPriceChanged(oldPrice, price_);
+        return price_;
+    }
+
+    BusinessMediator* mediator_{ nullptr };
+    std::int32_t stock_{ 0 };
+    std::int32_t price_{ 100 };
+};
+
+class Restaurant
+{
+public:
+    std::int32_t CookFood()
+    {
+        if (isOpened_)
+        {
+            if (mediator_) mediator_->FoodIsCooked();
+            return price_;
+        }
+        else
+        {
+            return -1;
+        }
+    }
+
+    std::int32_t AlterPrice(std::int32_t priceChange)
+    {
+        price_ += priceChange;
+        return price_;
+    }
+
+    BusinessMediator* mediator_{ nullptr };
+    bool isOpened_{ true };
+    std::int32_t price_{ 500 };
+};
+
+BusinessMediator::BusinessMediator(EstateOwner& estateOwner, GroceryStore& groceryStore, Restaurant& restaurant)
+    : groceryStore_(groceryStore), restaurant_(restaurant)
+{
+    estateOwner.mediator_ = this;
+    groceryStore.mediator_ = this;
+    restaurant.mediator_ = this;
+}
+
+void BusinessMediator::EstateRentPriceChanged(std::int32_t oldPrice, std::int32_t newPrice)
+{
+    groceryStore_.AlterPrice((newPrice - oldPrice) / 10000);
+    restaurant_.AlterPrice((newPrice - oldPrice) / 1000);
+}
+
+void BusinessMediator::GroceryStockChanged(std::int32_t currentStock)
+{
+    restaurant_.isOpened_ = currentStock > 0;
+}
+
+void BusinessMediator::GroceryPriceChanged(std::int32_t oldPrice, std::int32_t newPrice)
+{
+    restaurant_.AlterPrice(newPrice - oldPrice);
+}
+
+void BusinessMediator::FoodIsCooked()
+{
+    groceryStore_.Sell();
+}
+
+} // namespace handwritten
+
+namespace function_bus
+{
+
+// event type 으로 std::map 에서 handler 목록을 찾고, std::function 으로 호출합니다.
+class EventBus
+{
+public:
+    template <typename Event>
+    void Subscribe(std::function<void(Event const&)> handler)
+    {
+        handlers_[typeid(Event)].push_back(
+            [handler](void const* event) { handler(*static_cast<Event const*>(event)); });
+    }
+
+    template <typename Event>
+    void Publish(Event const& event)
+    {
+        auto iter = handlers_.find(typeid(Event));
+        if (iter == handlers_.end())
+        {
+            return;
+        }
+
+        for (auto const& handler : iter->second)
+        {
+            handler(&event);
+        }
+    }
+
+private:
+    std::map<std::type_index, std::vector<std::function<void(void const*)>>> handlers_;
+};
+
+class EstateOwner
+{
+public:
+    std::int32_t SetEstateRentPrice(std::int32_t price)
+    {
+        auto oldPrice = estateRentPrice_;
+        estateRentPrice_ = price;
+        if (bus_) bus_->Publish(EstateRentPriceChanged{ oldPrice, price });
+        return oldPrice;
+    }
+
+    EventBus* bus_{ nullptr };
+    std::int32_t estateRentPrice_{ 10000 };
+};
+
+class GroceryStore
+{
+public:
+    std::int32_t Supply(std::uint16_t count)
+    {
+        stock_ += count;
+        if (bus_) bus_->Publish(GroceryStockChanged{ stock_ });
+        return stock_;
+    }
+
+    std::int32_t Sell()
+    {
+        if (stock_ <= 0)
+        {
+            throw std::logic_error("Not in stock.");
+        }
+
+        --stock_;
+        if (bus_) bus_->Publish(GroceryStockChanged{ stock_ });
+        return price_;
+    }
+
+    std::int32_t AlterPrice(std::int32_t priceChange)
+    {
+        auto oldPrice = price_;
+        price_ += priceChange;
+        if (bus_) bus_->Publish(GroceryPriceChanged{ oldPrice, price_ });
+        return price_;
+    }
+
+    EventBus* bus_{ nullptr };
+    std::int32_t stock_{ 0 };
+    std::int32_t price_{ 100 };
+};
+
+class Restaurant
+{
+public:
+    std::int32_t CookFood()
+    {
+        if (isOpened_)
+        {
+            if (bus_) bus_->Publish(FoodIsCooked{});
+            return price_;
+        }
+        else
+        {
+            return -1;
+        }
+    }
+
+    std::int32_t AlterPrice(std::int32_t priceChange)
+    {
+        price_ += priceChange;
+        return price_;
+    }
+
+    EventBus* bus_{ nullptr };
+    bool isOpened_{ true };
+    std::int32_t price_{ 500 };
+};
+
+class BusinessMediator
+{
+public:
+    BusinessMediator(EstateOwner& estateOwner, GroceryStore& groceryStore, Restaurant& restaurant)
+    {
+        bus_.Subscribe<EstateRentPriceChanged>([&](EstateRentPriceChanged const& event)
+        {
+            groceryStore.AlterPrice((event.newPrice - event.oldPrice) / 10000);
+            restaurant.AlterPrice((event.newPrice - event.oldPrice) / 1000);
+        });
+        bus_.Subscribe<GroceryStockChanged>([&](GroceryStockChanged const& event)
+        {
+            restaurant.isOpened_ = event.currentStock > 0;
+        });
+        bus_.Subscribe<GroceryPriceChanged>([&](GroceryPriceChanged const& event)
+        {
+            restaurant.AlterPrice(event.newPrice - event.oldPrice);
+        });
+        bus_.Subscribe<FoodIsCooked>([&](FoodIsCooked const&)
+        {
+            groceryStore.Sell();
+        });
+        bus_.Subscribe<EstateRentPriceChanged>([this](EstateRentPriceChanged const&) { ++priceChangeCount_; });
+        bus_.Subscribe<GroceryPriceChanged>([this](GroceryPriceChanged const&) { ++priceChangeCount_; });
+
+        estateOwner.bus_ = &bus_;
+        groceryStore.bus_ = &bus_;
+        restaurant.bus_ = &bus_;
+    }
+
+private:
+    EventBus bus_;
+    std::uint64_t priceChangeCount_{ 0 };
+};
+
+} // namespace function_bus
+
+// 모든 구현이 같은 순서로 같은 요청들을 처리합니다.
+template <typename EstateOwnerT, typename GroceryStoreT, typename RestaurantT, typename MediatorT>
+void Benchmark(char const* name, std::size_t roundCount)
+{
+    EstateOwnerT estateOwner;
+    GroceryStoreT groceryStore;
+    RestaurantT restaurant;
+    MediatorT mediator(estateOwner, groceryStore, restaurant);
+
+    std::int64_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t round = 0; round < roundCount; ++round)
+    {
+        groceryStore.Supply(2);
+        checksum += estateOwner.SetEstateRentPrice(static_cast<std::int32_t>(10000 + (round % 7) * 5000));
+        checksum += groceryStore.AlterPrice(round % 2 ? 3 : -3);
+        checksum += restaurant.CookFood();
+        checksum += restaurant.CookFood();
+        checksum += restaurant.CookFood();
+    }
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << name << elapsed << " ms (checksum " << checksum << ")" << std::endl;
+}
+
+int main()
+{
+    EstateOwner estateOwner;
+    GroceryStore groceryStore;
+    Restaurant restaurant;
+
+    BusinessMediator mediator(estateOwner, groceryStore, restaurant);
+
+    SupplyGrocery(groceryStore, 2);
+    groceryStore.Sell();
+    BuyFood(restaurant);
+    BuyFood(restaurant);
+    std::cout << std::endl;
+
+    SupplyGrocery(groceryStore, 3);
+    ChangeEstateRentPrice(estateOwner, 1000);
+    BuyFood(restaurant);
+    ChangeEstateRentPrice(estateOwner, 10000);
+    BuyFood(restaurant);
+    ChangeEstateRentPrice(estateOwner, 100000);
+    BuyFood(restaurant);
+    std::cout << std::endl;
+
+    SupplyGrocery(groceryStore, 3);
+    ChangeGroceryPrice(groceryStore, 100);
+    BuyFood(restaurant);
+    ChangeEstateRentPrice(estateOwner, 10000);
+    BuyFood(restaurant);
+    ChangeGroceryPrice(groceryStore, -100);
+    BuyFood(restaurant);
+    BuyFood(restaurant);
+    std::cout << "Price changes seen by PriceMonitor : " << mediator.GetPriceMonitor().GetPriceChangeCount() << std::endl;
+    std::cout << std::endl;
+
+    std::cout << "---- Benchmark (10,000,000 rounds) ----" << std::endl;
+    Benchmark<handwritten::EstateOwner, handwritten::GroceryStore, handwritten::Restaurant,
+              handwritten::BusinessMediator>("hand-written mediator : ", 10000000);
+    Benchmark<function_bus::EstateOwner, function_bus::GroceryStore, function_bus::Restaurant,
+              function_bus::BusinessMediator>("std::function bus     : ", 10000000);
+    Benchmark<EstateOwner, GroceryStore, Restaurant, BusinessMediator>("typed event bus       : ", 10000000);
+}
@@ -0,0 +1,508 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../AccessKey.h"
+
+class EstateOwner;
+class GroceryStore;
+class Restaurant;
+
+////////////////////////////////////////////////////////////////////////////////
+class BusinessMediator
+{
+public:
+    BusinessMediator(EstateOwner& estateOwner, GroceryStore& groceryStore, Restaurant& restaurant);
+
+    void EstateRentPriceChanged(std::int32_t oldPrice, std::int32_t newPrice);
+    void GroceryStockChanged(std::int32_t currentStock);
+    void GroceryPriceChanged(std::int32_t oldPrice, std::int32_t newPrice);
+    void FoodIsCooked();
+
+private:
+    EstateOwner& estateOwner_;
+    GroceryStore& groceryStore_;
+    Restaurant& restaurant_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+class EstateOwner
+{
+public:
+    std::int32_t SetEstateRentPrice(std::int32_t price)
+    {
+        auto oldPrice = estateRentPrice_;
+        estateRentPrice_ = price;
+        if (mediator_) mediator_->EstateRentPriceChanged(oldPrice, price);
+        return oldPrice;
+    }
+
+    std::int32_t GetEstateRentPrice() const { return estateRentPrice_; }
+
+    BusinessMediator* SetBusinessMediator(design::AccessKey<BusinessMediator>,
+                                          BusinessMediator* mediator)
+    {
+        BusinessMediator* old = mediator_;
+        mediator_ = mediator;
+        return old;
+    }
+
+private:
+    BusinessMediator* mediator_{ nullptr };
+    std::int32_t estateRentPrice_{ 10000 };
+};
+
+////////////////////////////////////////////////////////////////////////////////
+class GroceryStore
+{
+public:
+    std::int32_t Supply(std::uint16_t count)
+    {
+        stock_ += count;
+        if (mediator_) mediator_->GroceryStockChanged(stock_);
+        return stock_;
+    }
+
+    std::int32_t Sell()
+    {
+        if (stock_ <= 0)
+        {
+            throw std::logic_error("Not in stock.");
+        }
+
+        --stock_;
+        if (mediator_) mediator_->GroceryStockChanged(stock_);
+        return price_;
+    }
+
+    std::int32_t AlterPrice(std::int32_t priceChange)
+    {
+        auto oldPrice = price_;
+        price_ += priceChange;
+        if (mediator_) mediator_->GroceryPriceChanged(oldPrice, price_);
+        return price_;
+    }
+
+    std::int32_t GetStock() const { return stock_; }
+    std::int32_t GetPrice() const { return price_; }
+
+    BusinessMediator* SetBusinessMediator(design::AccessKey<BusinessMediator>,
+                                          BusinessMediator* mediator)
+    {
+        BusinessMediator* old = mediator_;
+        mediator_ = mediator;
+        return old;
+    }
+
+private:
+    BusinessMediator* mediator_{ nullptr };
+    std::int32_t stock_{ 0 };
+    std::int32_t price_{ 100 };
+};
+
+////////////////////////////////////////////////////////////////////////////////
+class Restaurant
+{
+public:
+    std::int32_t CookFood()
+    {
+        if (isOpened_)
+        {
+            if (mediator_) mediator_->FoodIsCooked();
+            return price_;
+        }
+        else
+        {
+            return -1;
+        }
+    }
+
+    std::int32_t AlterPrice(std::int32_t priceChange)
+    {
+        price_ += priceChange;
+        return price_;
+    }
+
+    std::int32_t GetPrice() const { return price_; }
+    bool IsOpened() const { return isOpened_; }
+
+    BusinessMediator* SetBusinessMediator(design::AccessKey<BusinessMediator>,
+                                          BusinessMediator* mediator)
+    {
+        BusinessMediator* old = mediator_;
+        mediator_ = mediator;
+        return old;
+    }
+
+    void SetIsOpened(design::AccessKey<BusinessMediator>,
+                     bool isOpened)
+    {
+        isOpened_ = isOpened;
+    }
+
+private:
+    BusinessMediator* mediator_{ nullptr };
+    bool isOpened_{ true };
+    std::int32_t price_{ 500 };
+};
+
+////////////////////////////////////////////////////////////////////////////////
+BusinessMediator::BusinessMediator(EstateOwner& estateOwner, GroceryStore& groceryStore, Restaurant& restaurant)
+    : estateOwner_(estateOwner), groceryStore_(groceryStore), restaurant_(restaurant)
+{
+    estateOwner_.SetBusinessMediator(design::AccessKey<BusinessMediator>(), this);
+    groceryStore_.SetBusinessMediator(design::AccessKey<BusinessMediator>(), this);
+    restaurant_.SetBusinessMediator(design::AccessKey<BusinessMediator>(), this);
+}
+
+void BusinessMediator::EstateRentPriceChanged(std::int32_t oldPrice, std::int32_t newPrice)
+{
+    groceryStore_.AlterPrice((newPrice - oldPrice) / 10000);
+    restaurant_.AlterPrice((newPrice - oldPrice) / 1000);
+}
+
+void BusinessMediator::GroceryStockChanged(std::int32_t currentStock)
+{
+    if (currentStock > 0)
+    {
+        restaurant_.SetIsOpened(design::AccessKey<BusinessMediator>(), true);
+    }
+    else
+    {
+        restaurant_.SetIsOpened(design::AccessKey<BusinessMediator>(), false);
+    }
+}
+
+void BusinessMediator::GroceryPriceChanged(std::int32_t oldPrice, std::int32_t newPrice)
+{
+    restaurant_.AlterPrice(newPrice - oldPrice);
+}
+
+void BusinessMediator::FoodIsCooked()
+{
+    groceryStore_.Sell();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/*
+    한 tick 동안 각 시장에 들어오는 요청들. 모두 시장 수 만큼의 길이를 가지는 column 입니다.
+    한 tick 안에서는 Supply -> 임대료 변경 -> 식료품 가격 변경 -> 음식 구매 순서로 적용됩니다.
+*/
+struct MarketInputs
+{
+    explicit MarketInputs(std::size_t marketCount)
+        : supplies(marketCount), estateRentPrices(marketCount),
+          groceryPriceChanges(marketCount), buyCounts(marketCount)
+    {}
+
+    std::vector<std::int32_t> supplies;
+    std::vector<std::int32_t> estateRentPrices;     //< 새 임대료 (바뀌지 않으면 현재 임대료와 같은 값)
+    std::vector<std::int32_t> groceryPriceChanges;
+    std::vector<std::int32_t> buyCounts;
+};
+
+/*
+    수많은 시장(EstateOwner, GroceryStore, Restaurant 와 BusinessMediator 한 벌)을 한꺼번에 시뮬레이션합니다.
+    객체마다 따로 있던 상태를 field 마다 하나의 연속된 배열(struct-of-arrays)로 모아두고,
+    BusinessMediator 의 규칙들을 배열 전체에 대한 batch kernel 로 적용합니다.
+      - EstateRentPriceChanged + GroceryPriceChanged : 임대료 변화량으로 식료품 가격과 음식 가격을 함께 갱신
+      - GroceryPriceChanged : 식료품 가격의 변화량을 음식 가격에 반영
+      - GroceryStockChanged : 재고가 있을 때만 영업
+      - FoodIsCooked : 영업 중이라면 재고만큼 판매하고, 재고가 바닥나면 영업을 멈춤
+    kernel 들은 분기 없는 단순한 반복문이므로, compiler 가 SIMD 로 vectorize 할 수 있습니다.
+    (GCC -O3 에서는 매출을 64 bit 로 합산하는 판매 kernel 을 제외한 세 kernel 이 vectorize 됩니다.)
+    Step 은 시장들을 core 수만큼의 shard 로 나누어, 각 shard 에 대해 네 kernel 을 차례로 실행합니다.
+
+    모든 시장은 initialStock 만큼 Supply 된 상태로 시작합니다. 따라서 항상 "영업 중 == 재고가 있음" 이 성립하고,
+    객체 버전에서 예외가 나는 경우(영업 중인데 재고가 없는 경우)는 생기지 않습니다.
+*/
+class MarketEngine
+{
+public:
+    MarketEngine(std::size_t marketCount, std::int32_t initialStock, std::size_t shardCount = 0)
+        : estateRentPrices_(marketCount, 10000),
+          groceryStocks_(marketCount, initialStock),
+          groceryPrices_(marketCount, 100),
+          restaurantPrices_(marketCount, 500),
+          isOpened_(marketCount, initialStock > 0),
+          shardCount_(shardCount ? shardCount : std::max(1u, std::thread::hardware_concurrency()))
+    {}
+
+    // 한 tick 을 진행하고, 모든 시장에서 팔린 음식 값의 합을 반환합니다.
+    std::int64_t Step(MarketInputs const& inputs)
+    {
+        auto marketCount = GetMarketCount();
+        // shard 경계가 cache line 을 나누어 갖지 않도록 64 개 단위로 자릅니다.
+        auto shardSize = ((marketCount + shardCount_ - 1) / shardCount_ + 63) / 64 * 64;
+
+        std::vector<std::int64_t> revenues(shardCount_, 0);
+        std::vector<std::thread> threads;
+
+        for (std::size_t shard = 1; shard < shardCount_; ++shard)
+        {
+            auto begin = std::min(marketCount, shard * shardSize);
+            auto end = std::min(marketCount, begin + shardSize);
+            threads.emplace_back([this, &inputs, &revenues, shard, begin, end]
+            {
+                revenues[shard] = StepShard_(inputs, begin, end);
+            });
+        }
+        revenues[0] = StepShard_(inputs, 0, std::min(marketCount, shardSize));
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        std::int64_t revenue = 0;
+        for (auto shardRevenue : revenues)
+        {
+            revenue += shardRevenue;
+        }
+        return revenue;
+    }
+
+    std::size_t GetMarketCount() const { return estateRentPrices_.size(); }
+
+    std::int32_t GetEstateRentPrice(std::size_t market) const { return estateRentPrices_[market]; }
+    std::int32_t GetGroceryStock(std::size_t market) const { return groceryStocks_[market]; }
+    std::int32_t GetGroceryPrice(std::size_t market) const { return groceryPrices_[market]; }
+    std::int32_t GetRestaurantPrice(std::size_t market) const { return restaurantPrices_[market]; }
+    bool IsOpened(std::size_t market) const { return isOpened_[market] != 0; }
+
+private:
+    std::int64_t StepShard_(MarketInputs const& inputs, std::size_t begin, std::size_t end)
+    {
+        SupplyKernel_(inputs.supplies.data(), begin, end);
+        EstateRentPriceKernel_(inputs.estateRentPrices.data(), begin, end);
+        GroceryPriceKernel_(inputs.groceryPriceChanges.data(), begin, end);
+        return BuyFoodKernel_(inputs.buyCounts.data(), begin, end);
+    }
+
+    // GroceryStore::Supply -> BusinessMediator::GroceryStockChanged
+    void SupplyKernel_(std::int32_t const* supplies, std::size_t begin, std::size_t end)
+    {
+        auto* stocks = groceryStocks_.data();
+        auto* isOpened = isOpened_.data();
+        for (auto i = begin; i < end; ++i)
+        {
+            auto stock = stocks[i] + supplies[i];
+            stocks[i] = stock;
+            // 재고 변화가 없으면 알림도 없으므로, 영업 여부를 그대로 둡니다.
+            isOpened[i] = supplies[i] != 0 ? static_cast<std::uint8_t>(stock > 0) : isOpened[i];
+        }
+    }
+
+    // EstateOwner::SetEstateRentPrice -> BusinessMediator::EstateRentPriceChanged
+    //   -> GroceryStore::AlterPrice -> BusinessMediator::GroceryPriceChanged
+    void EstateRentPriceKernel_(std::int32_t const* newPrices, std::size_t begin, std::size_t end)
+    {
+        auto* rentPrices = estateRentPrices_.data();
+        auto* groceryPrices = groceryPrices_.data();
+        auto* restaurantPrices = restaurantPrices_.data();
+        for (auto i = begin; i < end; ++i)
+        {
+            auto change = newPrices[i] - rentPrices[i];
+            auto groceryChange = change / 10000;
+            rentPrices[i] = newPrices[i];
+            groceryPrices[i] += groceryChange;
+            restaurantPrices[i] += change / 1000 + groceryChange;
+        }
+    }
+
+    // GroceryStore::AlterPrice -> BusinessMediator::GroceryPriceChanged
+    void GroceryPriceKernel_(std::int32_t const* priceChanges, std::size_t begin, std::size_t end)
+    {
+        auto* groceryPrices = groceryPrices_.data();
+        auto* restaurantPrices = restaurantPrices_.data();
+        for (auto i = begin; i < end; ++i)
+        {
+            groceryPrices[i] += priceChanges[i];
+            restaurantPrices[i] += priceChanges[i];
+        }
+    }
+
+    // buyCounts[i] 번의 Restaurant::CookFood -> BusinessMediator::FoodIsCooked -> GroceryStore::Sell
+    std::int64_t BuyFoodKernel_(std::int32_t const* buyCounts, std::size_t begin, std::size_t end)
+    {
+        auto* stocks = groceryStocks_.data();
+        auto* isOpened = isOpened_.data();
+        auto const* restaurantPrices = restaurantPrices_.data();
+        std::int64_t revenue = 0;
+        for (auto i = begin; i < end; ++i)
+        {
+            auto sold = isOpened[i] ? std::min(buyCounts[i], stocks[i]) : 0;
+            auto stock = stocks[i] - sold;
+            stocks[i] = stock;
+            isOpened[i] = sold != 0 ? static_cast<std::uint8_t>(stock > 0) : isOpened[i];
+            revenue += static_cast<std::int64_t>(sold) * restaurantPrices[i];
+        }
+        return revenue;
+    }
+
+    std::vector<std::int32_t> estateRentPrices_;
+    std::vector<std::int32_t> groceryStocks_;
+    std::vector<std::int32_t> groceryPrices_;
+    std::vector<std::int32_t> restaurantPrices_;
+    std::vector<std::uint8_t> isOpened_;
+    std::size_t shardCount_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// 같은 요청들을 객체 버전에 적용합니다. (parity test 와 benchmark 에서 사용합니다.)
+
+struct Market
+{
+    Market()
+        : mediator(estateOwner, groceryStore, restaurant)
+    {}
+
+    EstateOwner estateOwner;
+    GroceryStore groceryStore;
+    Restaurant restaurant;
+    BusinessMediator mediator;
+};
+
+std::vector<std::unique_ptr<Market>> MakeMarkets(std::size_t marketCount, std::uint16_t initialStock)
+{
+    std::vector<std::unique_ptr<Market>> markets;
+    markets.reserve(marketCount);
+    for (std::size_t i = 0; i < marketCount; ++i)
+    {
+        markets.push_back(std::make_unique<Market>());
+        markets.back()->groceryStore.Supply(initialStock);
+    }
+    return markets;
+}
+
+std::int64_t StepMarkets(std::vector<std::unique_ptr<Market>>& markets, MarketInputs const& inputs)
+{
+    std::int64_t revenue = 0;
+    for (std::size_t i = 0; i < markets.size(); ++i)
+    {
+        auto& market = *markets[i];
+        if (inputs.supplies[i] != 0)
+            market.groceryStore.Supply(static_cast<std::uint16_t>(inputs.supplies[i]));
+        market.estateOwner.SetEstateRentPrice(inputs.estateRentPrices[i]);
+        if (inputs.groceryPriceChanges[i] != 0)
+            market.groceryStore.AlterPrice(inputs.groceryPriceChanges[i]);
+
+        // 음식 값이 음수가 될 수도 있으므로, 반환값 대신 영업 여부로 판매를 구분합니다.
+        for (std::int32_t count = 0; count < inputs.buyCounts[i] && market.restaurant.IsOpened(); ++count)
+        {
+            revenue += market.restaurant.CookFood();
+        }
+    }
+    return revenue;
+}
+
+void FillInputs(MarketInputs& inputs, std::mt19937& random, std::vector<std::int32_t> const& currentRentPrices)
+{
+    std::uniform_int_distribution<std::int32_t> percent(0, 99);
+    std::uniform_int_distribution<std::int32_t> supply(1, 5);
+    std::uniform_int_distribution<std::int32_t> rentPrice(1000, 300000);
+    std::uniform_int_distribution<std::int32_t> priceChange(-20, 20);
+    std::uniform_int_distribution<std::int32_t> buyCount(0, 4);
+
+    for (std::size_t i = 0; i < inputs.supplies.size(); ++i)
+    {
+        inputs.supplies[i] = percent(random) < 30 ? supply(random) : 0;
+        inputs.estateRentPrices[i] = percent(random) < 10 ? rentPrice(random) : currentRentPrices[i];
+        inputs.groceryPriceChanges[i] = percent(random) < 20 ? priceChange(random) : 0;
+        inputs.buyCounts[i] = buyCount(random);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Parity Test : 무작위 요청들을 두 버전에 똑같이 적용하고, 모든 상태가 같은지 확인합니다.
+
+bool RunParityTest(std::size_t marketCount, std::size_t tickCount, std::size_t shardCount)
+{
+    auto markets = MakeMarkets(marketCount, 3);
+    MarketEngine engine(marketCount, 3, shardCount);
+    MarketInputs inputs(marketCount);
+    std::vector<std::int32_t> rentPrices(marketCount);
+    std::mt19937 random(7);
+
+    for (std::size_t tick = 0; tick < tickCount; ++tick)
+    {
+        for (std::size_t i = 0; i < marketCount; ++i)
+            rentPrices[i] = engine.GetEstateRentPrice(i);
+        FillInputs(inputs, random, rentPrices);
+
+        auto objectRevenue = StepMarkets(markets, inputs);
+        auto engineRevenue = engine.Step(inputs);
+        if (objectRevenue != engineRevenue)
+        {
+            std::cout << "revenue mismatch at tick " << tick << " : "
+                << objectRevenue << " != " << engineRevenue << std::endl;
+            return false;
+        }
+
+        for (std::size_t i = 0; i < marketCount; ++i)
+        {
+            auto const& market = *markets[i];
+            if (market.estateOwner.GetEstateRentPrice() != engine.GetEstateRentPrice(i) ||
+                market.groceryStore.GetStock() != engine.GetGroceryStock(i) ||
+                market.groceryStore.GetPrice() != engine.GetGroceryPrice(i) ||
+                market.restaurant.GetPrice() != engine.GetRestaurantPrice(i) ||
+                market.restaurant.IsOpened() != engine.IsOpened(i))
+            {
+                std::cout << "state mismatch at tick " << tick << ", market " << i << std::endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Benchmark
+
+void Benchmark(std::size_t marketCount, std::size_t tickCount)
+{
+    MarketInputs inputs(marketCount);
+    std::vector<std::int32_t> rentPrices(marketCount, 10000);
+    std::mt19937 random(42);
+    FillInputs(inputs, random, rentPrices);
+
+    auto measure = [&](auto&& step)
+    {
+        std::int64_t revenue = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t tick = 0; tick < tickCount; ++tick)
+            revenue += step();
+        auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << elapsed << " ms (revenue " << revenue << ")" << std::endl;
+    };
+
+    auto markets = MakeMarkets(marketCount, 3);
+    std::cout << "objects              : ";
+    measure([&] { return StepMarkets(markets, inputs); });
+
+    MarketEngine singleEngine(marketCount, 3, 1);
+    std::cout << "engine, 1 shard      : ";
+    measure([&] { return singleEngine.Step(inputs); });
+
+    MarketEngine engine(marketCount, 3);
+    auto shardCount = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << "engine, " << shardCount << " shard(s)   : ";
+    measure([&] { return engine.Step(inputs); });
+}
+
+int main()
+{
+    std::cout << "Parity test (1 shard)  : " << (RunParityTest(10000, 50, 1) ? "passed" : "FAILED") << std::endl;
+    std::cout << "Parity test (4 shards) : " << (RunParityTest(10000, 50, 4) ? "passed" : "FAILED") << std::endl;
+
+    std::cout << "---- Benchmark (500,000 markets, 100 ticks) ----" << std::endl;
+    Benchmark(500000, 100);
+}
@@ -0,0 +1,301 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Mementor 클래스
+class Snapshot
+{
+private:
+    friend class VirtualMachine;
+
+    // 예시를 위해 간단하게 했지만, 실제로는 외부에 노출되면 안되는 많은 상태 정보들이
+    // 들어있을 것입니다.
+    struct State
+    {
+        std::uint16_t cpuCount{ 1 };
+        std::uint64_t ramSize{ 500 };
+        // ...
+    };
+
+    explicit Snapshot(State const& state)
+        : state_(state)
+    {}
+
+    State state_;
+};
+
+/*
+    Originator 클래스
+    상태는 seqlock 으로 보호합니다. 상태를 바꾸는 thread (writer) 는 하나여야 하고, 절대 기다리지 않습니다.
+    다른 thread 들은 언제든지 TakeSnapshot 이나 Get 함수들을 부를 수 있고,
+    읽는 도중에 상태가 바뀌었다면 다시 읽으므로, 항상 어느 한 시점의 온전한 상태를 얻습니다.
+    (field 들은 relaxed atomic 으로 두어서, 읽고 쓰는 것이 겹쳐도 data race 가 되지 않게 합니다.)
+*/
+class VirtualMachine
+{
+public:
+    std::uint16_t GetCpuCount() const { return Read_().cpuCount; }
+    std::uint64_t GetRamSize() const { return Read_().ramSize; }
+
+    std::uint16_t ChangeCpuCount(std::uint16_t cpuCount)
+    {
+        auto old = cpuCount_.load(std::memory_order_relaxed);
+        Write_(cpuCount, ramSize_.load(std::memory_order_relaxed));
+        return old;
+    }
+
+    std::uint64_t ChangeRamSize(std::uint64_t ramSize)
+    {
+        auto old = ramSize_.load(std::memory_order_relaxed);
+        Write_(cpuCount_.load(std::memory_order_relaxed), ramSize);
+        return old;
+    }
+
+    // 여러 field 를 한 번에 바꿉니다. snapshot 에는 둘 다 바뀌기 전이나, 둘 다 바뀐 후의 상태만 보입니다.
+    void Reconfigure(std::uint16_t cpuCount, std::uint64_t ramSize)
+    {
+        Write_(cpuCount, ramSize);
+    }
+
+    void ResetToSnapshot(Snapshot const& snapshot)
+    {
+        Write_(snapshot.state_.cpuCount, snapshot.state_.ramSize);
+    }
+
+    // 어느 thread 에서 불러도 되고, writer 를 막지 않습니다.
+    Snapshot TakeSnapshot() const
+    {
+        return Snapshot(Read_());
+    }
+
+private:
+    // sequence 가 홀수인 동안은 쓰는 중입니다.
+    void Write_(std::uint16_t cpuCount, std::uint64_t ramSize)
+    {
+        auto sequence = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        cpuCount_.store(cpuCount, std::memory_order_relaxed);
+        ramSize_.store(ramSize, std::memory_order_relaxed);
+
+        sequence_.store(sequence + 2, std::memory_order_release);
+    }
+
+    Snapshot::State Read_() const
+    {
+        Snapshot::State state;
+        while (true)
+        {
+            auto before = sequence_.load(std::memory_order_acquire);
+            if (before & 1)
+            {
+                // writer 가 쓰는 도중에 선점되었을 수 있으므로, 계속 돌지 않고 양보합니다.
+                std::this_thread::yield();
+                continue;
+            }
+
+            state.cpuCount = cpuCount_.load(std::memory_order_relaxed);
+            state.ramSize = ramSize_.load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence_.load(std::memory_order_relaxed) == before)
+            {
+                return state;
+            }
+        }
+    }
+
+    alignas(64) std::atomic<std::uint32_t> sequence_{ 0 };
+    std::atomic<std::uint16_t> cpuCount_{ 1 };
+    std::atomic<std::uint64_t> ramSize_{ 500 };
+};
+
+void PrintVmInfo(VirtualMachine const& vm)
+{
+    std::cout << "----------------" << std::endl;
+    std::cout << "Cpu Count : " << vm.GetCpuCount() << std::endl;
+    std::cout << "Ram Size  : " << vm.GetRamSize() << std::endl << std::endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Stress Test : writer 는 항상 ramSize 의 하위 16 bit 가 cpuCount 와 같도록 바꾸고,
+//               monitor 들은 쉬지 않고 snapshot 을 찍어서 이 관계가 깨진 snapshot 이 있는지 확인합니다.
+
+void RunStressTest(std::size_t monitorCount, std::uint64_t writeCount)
+{
+    VirtualMachine vm;
+    vm.Reconfigure(0, 0);
+
+    std::atomic<bool> isDone{ false };
+    std::atomic<std::uint64_t> snapshotCount{ 0 };
+    std::atomic<std::uint64_t> tornCount{ 0 };
+
+    std::vector<std::thread> monitors;
+    for (std::size_t i = 0; i < monitorCount; ++i)
+    {
+        monitors.emplace_back([&]
+        {
+            // Snapshot 의 내용은 Originator 만 볼 수 있으므로, 다른 VirtualMachine 으로 되돌려서 확인합니다.
+            VirtualMachine checker;
+            std::uint64_t count = 0;
+            std::uint64_t torn = 0;
+            std::uint64_t lastVersion = 0;
+            while (!isDone.load(std::memory_order_relaxed))
+            {
+                checker.ResetToSnapshot(vm.TakeSnapshot());
+                auto ramSize = checker.GetRamSize();
+                auto version = ramSize >> 16;
+                if ((ramSize & 0xffff) != checker.GetCpuCount() || version < lastVersion)
+                    ++torn;
+                lastVersion = version;
+                ++count;
+            }
+            snapshotCount += count;
+            tornCount += torn;
+        });
+    }
+
+    for (std::uint64_t i = 1; i <= writeCount; ++i)
+    {
+        auto cpuCount = static_cast<std::uint16_t>(i * 2654435761u >> 16);
+        vm.Reconfigure(cpuCount, (i << 16) | cpuCount);
+    }
+    isDone = true;
+
+    for (auto& monitor : monitors)
+        monitor.join();
+
+    std::cout << "Stress test : " << writeCount << " writes, " << monitorCount << " monitors, "
+        << snapshotCount << " snapshots, " << tornCount << " torn -> "
+        << (tornCount == 0 ? "correct" : "WRONG") << std::endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Benchmark : monitor 가 snapshot 을 찍는 빈도에 따라 writer 가 얼마나 느려지는지 잽니다.
+//             mutex 로 보호하는 VirtualMachine 과 비교합니다.
+
+namespace locked
+{
+
+class VirtualMachine
+{
+public:
+    struct State
+    {
+        std::uint16_t cpuCount{ 1 };
+        std::uint64_t ramSize{ 500 };
+    };
+
+    void Reconfigure(std::uint16_t cpuCount, std::uint64_t ramSize)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        state_.cpuCount = cpuCount;
+        state_.ramSize = ramSize;
+    }
+
+    State TakeSnapshot() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return state_;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    State state_;
+};
+
+} // namespace locked
+
+// interval 이 0 이면 쉬지 않고 찍고, 음수면 monitor 를 띄우지 않습니다.
+template <typename Vm>
+void MeasureWriter(char const* name, std::chrono::microseconds interval, std::uint64_t writeCount)
+{
+    Vm vm;
+    std::atomic<bool> isDone{ false };
+    std::uint64_t snapshotCount = 0;
+
+    std::thread monitor;
+    if (interval.count() >= 0)
+    {
+        monitor = std::thread([&]
+        {
+            while (!isDone.load(std::memory_order_relaxed))
+            {
+                vm.TakeSnapshot();
+                ++snapshotCount;
+                if (interval.count() > 0)
+                    std::this_thread::sleep_for(interval);
+            }
+        });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::uint64_t i = 0; i < writeCount; ++i)
+    {
+        vm.Reconfigure(static_cast<std::uint16_t>(i), i);
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    isDone = true;
+
+    if (monitor.joinable())
+        monitor.join();
+
+    std::cout << "  " << name << " : " << elapsed * 1e9 / writeCount << " ns/write, "
+        << static_cast<std::uint64_t>(snapshotCount / elapsed) << " snapshots/s" << std::endl;
+}
+
+void Benchmark(std::uint64_t writeCount)
+{
+    struct Case
+    {
+        char const* name;
+        std::chrono::microseconds interval;
+    };
+    Case const cases[] = {
+        { "no monitor     ", std::chrono::microseconds(-1) },
+        { "every 1 ms     ", std::chrono::microseconds(1000) },
+        { "every 10 us    ", std::chrono::microseconds(10) },
+        { "back-to-back   ", std::chrono::microseconds(0) },
+    };
+
+    std::cout << writeCount << " writes, " << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+    for (auto const& c : cases)
+    {
+        std::cout << c.name << std::endl;
+        MeasureWriter<VirtualMachine>("seqlock", c.interval, writeCount);
+        MeasureWriter<locked::VirtualMachine>("mutex  ", c.interval, writeCount);
+    }
+}
+
+int main()
+{
+    VirtualMachine vm;
+
+    PrintVmInfo(vm);
+    auto snapshot_1 = vm.TakeSnapshot();
+
+    vm.ChangeCpuCount(16);
+    vm.ChangeRamSize(1500);
+    PrintVmInfo(vm);
+    auto snapshot_2 = vm.TakeSnapshot();
+
+    vm.ResetToSnapshot(snapshot_1);
+    PrintVmInfo(vm);
+
+    vm.ChangeCpuCount(4);
+    vm.ChangeRamSize(6000);
+    PrintVmInfo(vm);
+
+    vm.ResetToSnapshot(snapshot_2);
+    PrintVmInfo(vm);
+
+    RunStressTest(std::max(2u, std::thread::hardware_concurrency()) - 1, 20000000);
+
+    std::cout << "---- Benchmark ----" << std::endl;
+    Benchmark(20000000);
+}
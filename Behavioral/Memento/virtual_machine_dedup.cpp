@@ -0,0 +1,529 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/*
+    내용으로 주소를 매기는 chunk 저장소.
+    같은 내용의 chunk 는 (서로 다른 VirtualMachine 의 것이라도) 한 번만 저장하고, 참조 횟수로 관리합니다.
+    hash 가 같으면 내용까지 비교하므로, hash 가 충돌해도 다른 chunk 가 합쳐지지 않습니다.
+    여러 thread 에서 동시에 사용할 수 없습니다.
+*/
+class ChunkStore
+{
+public:
+    using ChunkId = std::uint32_t;
+    static constexpr std::size_t kChunkSize = 4096;
+
+    struct Statistics
+    {
+        std::size_t uniqueChunkCount{ 0 };  //< 실제로 저장된 chunk 의 수
+        std::size_t referenceCount{ 0 };    //< 모든 참조의 수 (참조는 ChunkGroup 이 가지고, ChunkGroup 은 snapshot 들이 공유합니다.)
+
+        std::size_t GetStoredBytes() const { return uniqueChunkCount * kChunkSize; }
+    };
+
+    // 같은 내용의 chunk 가 있으면 그것의 참조 횟수를 늘리고, 없으면 새로 저장합니다.
+    ChunkId Intern(std::uint8_t const* data)
+    {
+        auto hash = Hash_(data);
+        auto range = index_.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (std::memcmp(chunks_[it->second].data.get(), data, kChunkSize) == 0)
+            {
+                AddRef(it->second);
+                return it->second;
+            }
+        }
+
+        ChunkId id;
+        if (freeIds_.empty())
+        {
+            id = static_cast<ChunkId>(chunks_.size());
+            chunks_.emplace_back();
+        }
+        else
+        {
+            id = freeIds_.back();
+            freeIds_.pop_back();
+        }
+
+        auto& chunk = chunks_[id];
+        chunk.data.reset(new std::uint8_t[kChunkSize]);
+        std::memcpy(chunk.data.get(), data, kChunkSize);
+        chunk.hash = hash;
+        chunk.refCount = 1;
+        index_.emplace(hash, id);
+
+        ++statistics_.uniqueChunkCount;
+        ++statistics_.referenceCount;
+        return id;
+    }
+
+    void AddRef(ChunkId id)
+    {
+        ++chunks_[id].refCount;
+        ++statistics_.referenceCount;
+    }
+
+    void Release(ChunkId id)
+    {
+        --statistics_.referenceCount;
+        auto& chunk = chunks_[id];
+        if (--chunk.refCount > 0)
+        {
+            return;
+        }
+
+        auto range = index_.equal_range(chunk.hash);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (it->second == id)
+            {
+                index_.erase(it);
+                break;
+            }
+        }
+        chunk.data.reset();
+        freeIds_.push_back(id);
+        --statistics_.uniqueChunkCount;
+    }
+
+    std::uint8_t const* GetData(ChunkId id) const { return chunks_[id].data.get(); }
+
+    Statistics const& GetStatistics() const { return statistics_; }
+
+private:
+    struct Chunk_
+    {
+        std::unique_ptr<std::uint8_t[]> data;
+        std::uint64_t hash{ 0 };
+        std::uint32_t refCount{ 0 };
+    };
+
+    // 서로 독립적인 4개의 lane 으로 나눠서 곱셈의 지연 시간을 겹치게 합니다.
+    static std::uint64_t Hash_(std::uint8_t const* data)
+    {
+        constexpr std::uint64_t kMultiplier = 0x9e3779b97f4a7c15ull;
+        std::uint64_t lanes[4] = { 0x243f6a8885a308d3ull, 0x13198a2e03707344ull, 0xa4093822299f31d0ull, 0x082efa98ec4e6c89ull };
+
+        for (std::size_t offset = 0; offset < kChunkSize; offset += sizeof(lanes))
+        {
+            for (std::size_t lane = 0; lane < 4; ++lane)
+            {
+                std::uint64_t word;
+                std::memcpy(&word, data + offset + lane * sizeof(word), sizeof(word));
+                lanes[lane] = (lanes[lane] ^ word) * kMultiplier;
+                lanes[lane] ^= lanes[lane] >> 29;
+            }
+        }
+
+        std::uint64_t hash = 0;
+        for (auto lane : lanes)
+        {
+            hash = (hash ^ lane) * kMultiplier;
+            hash ^= hash >> 32;
+        }
+        return hash;
+    }
+
+    std::vector<Chunk_> chunks_;
+    std::vector<ChunkId> freeIds_;
+    std::unordered_multimap<std::uint64_t, ChunkId> index_;
+    Statistics statistics_;
+};
+
+constexpr std::size_t ChunkStore::kChunkSize;
+
+/*
+    memory 의 연속된 chunk kSize 개의 id 를 묶은 것.
+    만든 뒤에는 바뀌지 않으므로 여러 snapshot 이 공유하고, 가진 id 마다 참조 횟수를 하나씩 가집니다.
+*/
+class ChunkGroup
+{
+public:
+    static constexpr std::size_t kSize = 64;
+
+    // chunks 의 참조 횟수를 넘겨받습니다.
+    ChunkGroup(std::shared_ptr<ChunkStore> store, std::vector<ChunkStore::ChunkId> chunks)
+        : store_(std::move(store)), chunks_(std::move(chunks))
+    {}
+
+    ~ChunkGroup()
+    {
+        for (auto id : chunks_)
+        {
+            store_->Release(id);
+        }
+    }
+
+    ChunkGroup(ChunkGroup const&) = delete;
+    ChunkGroup& operator=(ChunkGroup const&) = delete;
+
+    std::vector<ChunkStore::ChunkId> const& GetChunks() const { return chunks_; }
+
+private:
+    std::shared_ptr<ChunkStore> store_;
+    std::vector<ChunkStore::ChunkId> chunks_;
+};
+
+constexpr std::size_t ChunkGroup::kSize;
+
+// Mementor 클래스
+// chunk 표는 바뀌지 않으므로, 복사해도 chunk 의 참조 횟수는 바뀌지 않습니다.
+class Snapshot
+{
+private:
+    friend class VirtualMachine;
+
+    using ChunkTable = std::vector<std::shared_ptr<ChunkGroup const>>;
+
+    // 예시를 위해 간단하게 했지만, 실제로는 외부에 노출되면 안되는 많은 상태 정보들이
+    // 들어있을 것입니다.
+    struct State
+    {
+        std::uint16_t cpuCount{ 1 };
+        std::uint64_t ramSize{ 500 };
+        std::shared_ptr<ChunkTable const> chunks;   //< memory 의 chunk 들을 ChunkGroup::kSize 개씩 묶은 표
+        // ...
+    };
+
+    Snapshot(std::shared_ptr<ChunkStore> store, State state)
+        : store_(std::move(store)), state_(std::move(state))
+    {}
+
+    std::shared_ptr<ChunkStore> store_;
+    State state_;
+};
+
+// Originator 클래스
+class VirtualMachine
+{
+public:
+    // 같은 ChunkStore 를 쓰는 VirtualMachine 들은 서로의 snapshot 과도 chunk 를 공유합니다.
+    explicit VirtualMachine(std::shared_ptr<ChunkStore> store, std::size_t memorySize = 1 << 20)
+        : store_(std::move(store)),
+          memory_((memorySize + ChunkStore::kChunkSize - 1) / ChunkStore::kChunkSize * ChunkStore::kChunkSize),
+          isDirty_(memory_.size() / ChunkStore::kChunkSize, false),
+          base_(store_, Snapshot::State{})
+    {
+        // 처음에는 모든 chunk 가 0 으로 채워진 같은 chunk 입니다.
+        auto table = std::make_shared<Snapshot::ChunkTable>();
+        base_.state_.chunks = table;
+        if (isDirty_.empty())
+        {
+            return;
+        }
+
+        auto zero = store_->Intern(memory_.data());
+        for (std::size_t first = 0; first < isDirty_.size(); first += ChunkGroup::kSize)
+        {
+            std::vector<ChunkStore::ChunkId> chunks(std::min(ChunkGroup::kSize, isDirty_.size() - first), zero);
+            for (std::size_t n = 0; n < chunks.size(); ++n)
+            {
+                store_->AddRef(zero);
+            }
+            table->push_back(std::make_shared<ChunkGroup const>(store_, std::move(chunks)));
+        }
+        store_->Release(zero);
+    }
+
+    std::uint16_t GetCpuCount() const { return state_.cpuCount; }
+    std::uint64_t GetRamSize() const { return state_.ramSize; }
+    std::size_t GetMemorySize() const { return memory_.size(); }
+
+    std::uint16_t ChangeCpuCount(std::uint16_t cpuCount)
+    {
+        auto old = state_.cpuCount;
+        state_.cpuCount = cpuCount;
+        return old;
+    }
+
+    std::uint64_t ChangeRamSize(std::uint64_t ramSize)
+    {
+        auto old = state_.ramSize;
+        state_.ramSize = ramSize;
+        return old;
+    }
+
+    void WriteMemory(std::size_t offset, void const* data, std::size_t size)
+    {
+        if (offset + size > memory_.size())
+        {
+            throw std::out_of_range("Memory write is out of range.");
+        }
+
+        std::memcpy(memory_.data() + offset, data, size);
+        if (size == 0)
+        {
+            return;
+        }
+
+        for (auto chunk = offset / ChunkStore::kChunkSize; chunk <= (offset + size - 1) / ChunkStore::kChunkSize; ++chunk)
+        {
+            if (!isDirty_[chunk])
+            {
+                isDirty_[chunk] = true;
+                dirtyChunks_.push_back(static_cast<std::uint32_t>(chunk));
+            }
+        }
+    }
+
+    void ReadMemory(std::size_t offset, void* data, std::size_t size) const
+    {
+        if (offset + size > memory_.size())
+        {
+            throw std::out_of_range("Memory read is out of range.");
+        }
+
+        std::memcpy(data, memory_.data() + offset, size);
+    }
+
+    // 지금의 memory 와 다른 chunk 와, 그 뒤로 바뀐 chunk 만 복사합니다.
+    void ResetToSnapshot(Snapshot const& snapshot)
+    {
+        auto const& groups = *snapshot.state_.chunks;
+        auto const& baseGroups = *base_.state_.chunks;
+        if (snapshot.store_ != store_ || groups.size() != baseGroups.size() ||
+            (!groups.empty() && groups.back()->GetChunks().size() != baseGroups.back()->GetChunks().size()))
+        {
+            throw std::invalid_argument("Snapshot is not taken from a compatible VirtualMachine.");
+        }
+
+        for (std::size_t group = 0; group < groups.size(); ++group)
+        {
+            // 같은 ChunkGroup 을 공유한다면, 그 뒤로 바뀐 chunk 만 복사하면 됩니다.
+            auto const& chunks = groups[group]->GetChunks();
+            auto const& baseChunks = baseGroups[group]->GetChunks();
+            auto isShared = groups[group] == baseGroups[group];
+            for (std::size_t n = 0; n < chunks.size(); ++n)
+            {
+                auto chunk = group * ChunkGroup::kSize + n;
+                if (isDirty_[chunk] || (!isShared && chunks[n] != baseChunks[n]))
+                {
+                    std::memcpy(memory_.data() + chunk * ChunkStore::kChunkSize, store_->GetData(chunks[n]), ChunkStore::kChunkSize);
+                }
+            }
+        }
+
+        state_.cpuCount = snapshot.state_.cpuCount;
+        state_.ramSize = snapshot.state_.ramSize;
+        ClearDirtyChunks_();
+        base_ = snapshot;
+    }
+
+    /*
+        마지막으로 찍거나 되돌린 snapshot 이후에 바뀐 chunk 들만 hash 해서 저장소에 넣습니다.
+        바뀐 chunk 가 있는 ChunkGroup 만 새로 만들고, 나머지 ChunkGroup 은 그 snapshot 과 공유합니다.
+    */
+    Snapshot TakeSnapshot() const
+    {
+        if (!dirtyChunks_.empty())
+        {
+            auto table = std::make_shared<Snapshot::ChunkTable>(*base_.state_.chunks);
+
+            std::sort(dirtyChunks_.begin(), dirtyChunks_.end());
+            for (std::size_t i = 0; i < dirtyChunks_.size();)
+            {
+                auto group = dirtyChunks_[i] / ChunkGroup::kSize;
+                auto const& oldChunks = (*table)[group]->GetChunks();
+
+                std::vector<ChunkStore::ChunkId> chunks(oldChunks.size());
+                for (std::size_t n = 0; n < chunks.size(); ++n)
+                {
+                    auto chunk = group * ChunkGroup::kSize + n;
+                    if (isDirty_[chunk])
+                    {
+                        chunks[n] = store_->Intern(memory_.data() + chunk * ChunkStore::kChunkSize);
+                    }
+                    else
+                    {
+                        chunks[n] = oldChunks[n];
+                        store_->AddRef(chunks[n]);
+                    }
+                }
+                (*table)[group] = std::make_shared<ChunkGroup const>(store_, std::move(chunks));
+
+                while (i < dirtyChunks_.size() && dirtyChunks_[i] / ChunkGroup::kSize == group)
+                {
+                    ++i;
+                }
+            }
+
+            base_.state_.chunks = std::move(table);
+            ClearDirtyChunks_();
+        }
+
+        base_.state_.cpuCount = state_.cpuCount;
+        base_.state_.ramSize = state_.ramSize;
+        return base_;
+    }
+
+private:
+    void ClearDirtyChunks_() const
+    {
+        for (auto chunk : dirtyChunks_)
+        {
+            isDirty_[chunk] = false;
+        }
+        dirtyChunks_.clear();
+    }
+
+    struct Registers_
+    {
+        std::uint16_t cpuCount{ 1 };
+        std::uint64_t ramSize{ 500 };
+    };
+
+    std::shared_ptr<ChunkStore> store_;
+    Registers_ state_;
+    std::vector<std::uint8_t> memory_;
+
+    // 어느 snapshot 으로부터 얼마나 바뀌었는지는 snapshot 을 찍는 데만 쓰이는 정보이므로 mutable 로 둡니다.
+    mutable std::vector<bool> isDirty_;
+    mutable std::vector<std::uint32_t> dirtyChunks_;
+    mutable Snapshot base_;
+};
+
+void PrintVmInfo(VirtualMachine const& vm)
+{
+    std::uint64_t firstWord = 0;
+    vm.ReadMemory(0, &firstWord, sizeof(firstWord));
+
+    std::cout << "----------------" << std::endl;
+    std::cout << "Cpu Count : " << vm.GetCpuCount() << std::endl;
+    std::cout << "Ram Size  : " << vm.GetRamSize() << std::endl;
+    std::cout << "Memory[0] : " << firstWord << std::endl << std::endl;
+}
+
+// logicalBytes 는 snapshot 들을 모두 따로 복사했다면 썼을 크기입니다.
+void PrintStatistics(ChunkStore const& store, std::size_t logicalBytes)
+{
+    auto storedBytes = store.GetStatistics().GetStoredBytes();
+    std::cout << "logical " << (logicalBytes >> 10) << " KiB, stored " << (storedBytes >> 10) << " KiB, saved "
+        << ((logicalBytes - std::min(logicalBytes, storedBytes)) >> 10) << " KiB, dedup ratio "
+        << (storedBytes ? double(logicalBytes) / storedBytes : 1.0) << std::endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Benchmark : 같은 image 로 부팅한 VirtualMachine 들이 각자 조금씩 memory 를 바꾸면서 snapshot 을 찍습니다.
+//             매번 전체 상태를 복사하는 snapshot 과 비교합니다.
+
+void Benchmark(std::size_t vmCount, std::size_t memorySize, std::size_t stepCount, std::size_t writesPerStep)
+{
+    auto store = std::make_shared<ChunkStore>();
+    std::mt19937_64 random(42);
+    std::uniform_int_distribution<std::size_t> offset(0, memorySize - sizeof(std::uint64_t));
+
+    std::vector<std::uint8_t> image(memorySize);
+    for (auto& byte : image)
+        byte = static_cast<std::uint8_t>(random());
+
+    std::vector<VirtualMachine> vms;
+    std::vector<Snapshot> snapshots;
+    for (std::size_t vm = 0; vm < vmCount; ++vm)
+    {
+        vms.emplace_back(store, memorySize);
+        vms.back().WriteMemory(0, image.data(), memorySize);
+        snapshots.push_back(vms.back().TakeSnapshot());
+    }
+
+    // 전체 복사본은 검증에 쓸 것들만 남겨둡니다. (메모리 사용량은 모두 남겨둔 것으로 계산합니다.)
+    std::vector<std::pair<std::size_t, std::vector<std::uint8_t>>> fullCopies;
+    double dedupTime = 0;
+    double fullTime = 0;
+
+    for (std::size_t step = 0; step < stepCount; ++step)
+    {
+        for (std::size_t vm = 0; vm < vmCount; ++vm)
+        {
+            for (std::size_t n = 0; n < writesPerStep; ++n)
+            {
+                auto value = random();
+                vms[vm].WriteMemory(offset(random), &value, sizeof(value));
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            snapshots.push_back(vms[vm].TakeSnapshot());
+            dedupTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            start = std::chrono::steady_clock::now();
+            std::vector<std::uint8_t> fullCopy(memorySize);
+            vms[vm].ReadMemory(0, fullCopy.data(), memorySize);
+            fullTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            if (vm == step % vmCount)
+                fullCopies.emplace_back(snapshots.size() - 1, std::move(fullCopy));
+        }
+    }
+
+    // 저장해둔 snapshot 들을 아무 VirtualMachine 에서나 되돌려보고, 전체 복사본과 같은지 확인합니다.
+    bool isCorrect = true;
+    std::vector<std::uint8_t> memory(memorySize);
+    for (auto const& fullCopy : fullCopies)
+    {
+        auto& vm = vms[random() % vmCount];
+        vm.ResetToSnapshot(snapshots[fullCopy.first]);
+        vm.ReadMemory(0, memory.data(), memorySize);
+        isCorrect = isCorrect && memory == fullCopy.second;
+    }
+
+    auto snapshotCount = vmCount * stepCount;
+    auto logicalBytes = snapshots.size() * memorySize;
+    auto storedBytes = store->GetStatistics().GetStoredBytes();
+    std::cout << vmCount << " VMs x " << stepCount << " snapshots of " << (memorySize >> 20) << " MiB, "
+        << writesPerStep << " writes each" << std::endl;
+    std::cout << "  full copy : " << fullTime / snapshotCount << " ms/snapshot, "
+        << (logicalBytes >> 20) << " MiB" << std::endl;
+    std::cout << "  dedup     : " << dedupTime / snapshotCount << " ms/snapshot, "
+        << (storedBytes >> 20) << " MiB, dedup ratio " << double(logicalBytes) / storedBytes << ", saved "
+        << ((logicalBytes - std::min(logicalBytes, storedBytes)) >> 20) << " MiB -> "
+        << (isCorrect ? "correct" : "WRONG") << std::endl;
+
+    snapshots.clear();
+    vms.clear();
+    std::cout << "  after release : " << store->GetStatistics().uniqueChunkCount << " chunks left" << std::endl;
+}
+
+int main()
+{
+    auto store = std::make_shared<ChunkStore>();
+    VirtualMachine vm(store);
+
+    PrintVmInfo(vm);
+    auto snapshot_1 = vm.TakeSnapshot();
+
+    std::uint64_t value = 42;
+    vm.ChangeCpuCount(16);
+    vm.ChangeRamSize(1500);
+    vm.WriteMemory(0, &value, sizeof(value));
+    PrintVmInfo(vm);
+    auto snapshot_2 = vm.TakeSnapshot();
+
+    vm.ResetToSnapshot(snapshot_1);
+    PrintVmInfo(vm);
+
+    value = 7;
+    vm.ChangeCpuCount(4);
+    vm.ChangeRamSize(6000);
+    vm.WriteMemory(0, &value, sizeof(value));
+    PrintVmInfo(vm);
+
+    vm.ResetToSnapshot(snapshot_2);
+    PrintVmInfo(vm);
+    PrintStatistics(*store, 2 * vm.GetMemorySize());
+    std::cout << std::endl;
+
+    std::cout << "---- Benchmark ----" << std::endl;
+    Benchmark(16, 4 << 20, 16, 16);
+    Benchmark(16, 4 << 20, 16, 256);
+}
@@ -0,0 +1,345 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+// Mementor 클래스
+class Snapshot
+{
+public:
+    // 이 Snapshot 으로 되돌리기 위해 적용해야 하는 delta 의 수. (전체 snapshot 이면 0)
+    std::size_t GetChainLength() const { return node_->chainLength; }
+
+    // 이 Snapshot 이 새로 복사해서 가지고 있는 page 의 크기. (다른 Snapshot 과 공유하는 page 는 제외)
+    std::size_t GetOwnedBytes() const { return node_->ownedPageCount * kPageSize; }
+
+private:
+    friend class VirtualMachine;
+
+    static constexpr std::size_t kPageSize = 4096;
+    using Page = std::array<std::uint8_t, kPageSize>;
+
+    // 예시를 위해 간단하게 했지만, 실제로는 외부에 노출되면 안되는 많은 상태 정보들이
+    // 들어있을 것입니다.
+    struct State
+    {
+        std::uint16_t cpuCount{ 1 };
+        std::uint64_t ramSize{ 500 };
+        // ...
+    };
+
+    /*
+        Snapshot 들은 부모를 가리키는 chain 을 이루며, 부모는 여러 자식들이 공유합니다.
+        전체 snapshot 은 모든 page 를 가지고, delta snapshot 은 부모 이후에 바뀐 page 들만 가집니다.
+        State 의 field 들은 page 에 비하면 매우 작으므로, delta 에도 항상 통째로 저장합니다.
+        한 번 만들어진 page 는 바뀌지 않으므로, 여러 snapshot 이 같은 page 를 공유할 수 있습니다.
+    */
+    struct Node
+    {
+        State state;
+        std::shared_ptr<Node const> parent;                 //< 전체 snapshot 이면 nullptr
+        std::size_t chainLength{ 0 };
+        std::vector<std::uint32_t> pageIndices;             //< delta 일 때, pages 의 각 page 의 번호 (오름차순)
+        std::vector<std::shared_ptr<Page const>> pages;     //< 전체 snapshot 이면 page 번호로 바로 찾습니다.
+        std::size_t ownedPageCount{ 0 };
+
+        bool IsFull() const { return !parent; }
+    };
+
+    explicit Snapshot(std::shared_ptr<Node const> node)
+        : node_(std::move(node))
+    {}
+
+    std::shared_ptr<Node const> node_;
+};
+
+// Originator 클래스
+class VirtualMachine
+{
+public:
+    // delta 가 이만큼 이어지면, 다음 snapshot 은 전체 snapshot 으로 만들어서 chain 의 길이를 제한합니다.
+    static constexpr std::size_t kCompactionInterval = 16;
+
+    explicit VirtualMachine(std::size_t memorySize = 1 << 20)
+        : memory_((memorySize + Snapshot::kPageSize - 1) / Snapshot::kPageSize * Snapshot::kPageSize),
+          isDirty_(memory_.size() / Snapshot::kPageSize, false)
+    {}
+
+    std::uint16_t GetCpuCount() const { return state_.cpuCount; }
+    std::uint64_t GetRamSize() const { return state_.ramSize; }
+    std::size_t GetMemorySize() const { return memory_.size(); }
+
+    std::uint16_t ChangeCpuCount(std::uint16_t cpuCount)
+    {
+        auto old = state_.cpuCount;
+        state_.cpuCount = cpuCount;
+        return old;
+    }
+
+    std::uint64_t ChangeRamSize(std::uint64_t ramSize)
+    {
+        auto old = state_.ramSize;
+        state_.ramSize = ramSize;
+        return old;
+    }
+
+    void WriteMemory(std::size_t offset, void const* data, std::size_t size)
+    {
+        if (offset + size > memory_.size())
+        {
+            throw std::out_of_range("Memory write is out of range.");
+        }
+
+        std::memcpy(memory_.data() + offset, data, size);
+        if (size == 0)
+        {
+            return;
+        }
+
+        for (auto page = offset / Snapshot::kPageSize; page <= (offset + size - 1) / Snapshot::kPageSize; ++page)
+        {
+            if (!isDirty_[page])
+            {
+                isDirty_[page] = true;
+                dirtyPages_.push_back(static_cast<std::uint32_t>(page));
+            }
+        }
+    }
+
+    void ReadMemory(std::size_t offset, void* data, std::size_t size) const
+    {
+        if (offset + size > memory_.size())
+        {
+            throw std::out_of_range("Memory read is out of range.");
+        }
+
+        std::memcpy(data, memory_.data() + offset, size);
+    }
+
+    /*
+        chain 을 따라 올라가면서, 각 page 의 가장 최근 내용을 한 번씩만 복사합니다.
+        지금의 memory 가 나온 snapshot 과 같은 page 를 공유하고, 그 뒤로 바뀌지 않은 page 는 복사하지 않습니다.
+    */
+    void ResetToSnapshot(Snapshot const& snapshot)
+    {
+        auto pages = ResolvePages_(*snapshot.node_);
+        auto currentPages = base_ ? ResolvePages_(*base_) : std::vector<std::shared_ptr<Snapshot::Page const>>(pages.size());
+        for (std::size_t page = 0; page < pages.size(); ++page)
+        {
+            if (isDirty_[page] || pages[page] != currentPages[page])
+            {
+                std::memcpy(memory_.data() + page * Snapshot::kPageSize, pages[page]->data(), Snapshot::kPageSize);
+            }
+        }
+
+        state_ = snapshot.node_->state;
+        ClearDirtyPages_();
+        base_ = snapshot.node_;
+    }
+
+    // 마지막으로 찍거나 되돌린 snapshot 이후에 바뀐 page 들만 복사합니다.
+    Snapshot TakeSnapshot() const
+    {
+        auto node = std::make_shared<Snapshot::Node>();
+        node->state = state_;
+
+        if (!base_ || base_->chainLength + 1 >= kCompactionInterval)
+        {
+            // 전체 snapshot 이라도, 바뀌지 않은 page 는 이전 snapshot 의 것을 공유합니다.
+            node->pages = base_ ? ResolvePages_(*base_) : std::vector<std::shared_ptr<Snapshot::Page const>>(isDirty_.size());
+            for (std::size_t page = 0; page < node->pages.size(); ++page)
+            {
+                if (!node->pages[page] || isDirty_[page])
+                {
+                    node->pages[page] = CopyPage_(page);
+                    ++node->ownedPageCount;
+                }
+            }
+        }
+        else
+        {
+            std::sort(dirtyPages_.begin(), dirtyPages_.end());
+            node->parent = base_;
+            node->chainLength = base_->chainLength + 1;
+            node->pageIndices = dirtyPages_;
+            for (auto page : dirtyPages_)
+            {
+                node->pages.push_back(CopyPage_(page));
+            }
+            node->ownedPageCount = dirtyPages_.size();
+        }
+
+        ClearDirtyPages_();
+        base_ = node;
+        return Snapshot(std::move(node));
+    }
+
+private:
+    std::shared_ptr<Snapshot::Page const> CopyPage_(std::size_t page) const
+    {
+        auto copy = std::make_shared<Snapshot::Page>();
+        std::memcpy(copy->data(), memory_.data() + page * Snapshot::kPageSize, Snapshot::kPageSize);
+        return copy;
+    }
+
+    // node 가 나타내는 시점의 모든 page 들을 page 번호 순서로 모읍니다. (page 의 내용은 복사하지 않습니다.)
+    std::vector<std::shared_ptr<Snapshot::Page const>> ResolvePages_(Snapshot::Node const& node) const
+    {
+        std::vector<std::shared_ptr<Snapshot::Page const>> pages(isDirty_.size());
+
+        for (auto const* current = &node; current; current = current->parent.get())
+        {
+            if (current->IsFull())
+            {
+                for (std::size_t page = 0; page < pages.size(); ++page)
+                {
+                    if (!pages[page]) pages[page] = current->pages[page];
+                }
+                break;
+            }
+
+            for (std::size_t i = 0; i < current->pageIndices.size(); ++i)
+            {
+                auto& page = pages[current->pageIndices[i]];
+                if (!page) page = current->pages[i];
+            }
+        }
+        return pages;
+    }
+
+    void ClearDirtyPages_() const
+    {
+        for (auto page : dirtyPages_)
+        {
+            isDirty_[page] = false;
+        }
+        dirtyPages_.clear();
+    }
+
+    Snapshot::State state_;
+    std::vector<std::uint8_t> memory_;
+
+    // 어느 snapshot 으로부터 얼마나 바뀌었는지는 snapshot 을 찍는 데만 쓰이는 정보이므로 mutable 로 둡니다.
+    mutable std::vector<bool> isDirty_;
+    mutable std::vector<std::uint32_t> dirtyPages_;
+    mutable std::shared_ptr<Snapshot::Node const> base_;
+};
+
+constexpr std::size_t Snapshot::kPageSize;
+constexpr std::size_t VirtualMachine::kCompactionInterval;
+
+void PrintVmInfo(VirtualMachine const& vm)
+{
+    std::uint64_t firstWord = 0;
+    vm.ReadMemory(0, &firstWord, sizeof(firstWord));
+
+    std::cout << "----------------" << std::endl;
+    std::cout << "Cpu Count : " << vm.GetCpuCount() << std::endl;
+    std::cout << "Ram Size  : " << vm.GetRamSize() << std::endl;
+    std::cout << "Memory[0] : " << firstWord << std::endl << std::endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Benchmark : 매번 전체 상태를 복사하는 snapshot 과 비교합니다.
+
+void Benchmark(std::size_t memorySize, std::size_t snapshotCount, std::size_t writesPerSnapshot)
+{
+    VirtualMachine vm(memorySize);
+    std::mt19937_64 random(42);
+    std::uniform_int_distribution<std::size_t> offset(0, memorySize - sizeof(std::uint64_t));
+
+    // 전체 복사본은 검증에 쓸 것들만 남겨둡니다. (메모리 사용량은 모두 남겨둔 것으로 계산합니다.)
+    std::size_t const verifyInterval = 16;
+    std::vector<Snapshot> snapshots;
+    std::vector<std::vector<std::uint8_t>> fullCopies;
+    std::vector<std::uint8_t> expected(memorySize);
+    double deltaTime = 0;
+    double fullTime = 0;
+    std::size_t deltaBytes = 0;
+
+    for (std::size_t i = 0; i < snapshotCount; ++i)
+    {
+        for (std::size_t n = 0; n < writesPerSnapshot; ++n)
+        {
+            auto value = random();
+            vm.WriteMemory(offset(random), &value, sizeof(value));
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        snapshots.push_back(vm.TakeSnapshot());
+        deltaTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        deltaBytes += snapshots.back().GetOwnedBytes();
+
+        start = std::chrono::steady_clock::now();
+        std::vector<std::uint8_t> fullCopy(vm.GetMemorySize());
+        vm.ReadMemory(0, fullCopy.data(), vm.GetMemorySize());
+        fullTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        if (i % verifyInterval == 0)
+            fullCopies.push_back(std::move(fullCopy));
+    }
+
+    // 무작위 snapshot 들로 되돌려보고, 전체 복사본과 같은지 확인합니다.
+    bool isCorrect = true;
+    double restoreTime = 0;
+    std::size_t const restoreCount = 100;
+    std::uniform_int_distribution<std::size_t> copyIndex(0, fullCopies.size() - 1);
+    for (std::size_t n = 0; n < restoreCount; ++n)
+    {
+        auto index = copyIndex(random);
+        auto start = std::chrono::steady_clock::now();
+        vm.ResetToSnapshot(snapshots[index * verifyInterval]);
+        restoreTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        vm.ReadMemory(0, expected.data(), memorySize);
+        isCorrect = isCorrect && expected == fullCopies[index];
+    }
+
+    std::cout << snapshotCount << " snapshots of " << (memorySize >> 20) << " MiB, " << writesPerSnapshot
+        << " writes each" << std::endl;
+    std::cout << "  full copy : " << fullTime / snapshotCount << " ms/snapshot, "
+        << ((snapshotCount * memorySize) >> 20) << " MiB" << std::endl;
+    std::cout << "  delta     : " << deltaTime / snapshotCount << " ms/snapshot, "
+        << (deltaBytes >> 20) << " MiB, restore " << restoreTime / restoreCount << " ms -> "
+        << (isCorrect ? "correct" : "WRONG") << std::endl;
+}
+
+int main()
+{
+    VirtualMachine vm;
+
+    PrintVmInfo(vm);
+    auto snapshot_1 = vm.TakeSnapshot();
+
+    std::uint64_t value = 42;
+    vm.ChangeCpuCount(16);
+    vm.ChangeRamSize(1500);
+    vm.WriteMemory(0, &value, sizeof(value));
+    PrintVmInfo(vm);
+    auto snapshot_2 = vm.TakeSnapshot();
+
+    vm.ResetToSnapshot(snapshot_1);
+    PrintVmInfo(vm);
+
+    value = 7;
+    vm.ChangeCpuCount(4);
+    vm.ChangeRamSize(6000);
+    vm.WriteMemory(0, &value, sizeof(value));
+    PrintVmInfo(vm);
+
+    vm.ResetToSnapshot(snapshot_2);
+    PrintVmInfo(vm);
+    std::cout << "snapshot_2 : chain length " << snapshot_2.GetChainLength()
+        << ", owned bytes " << snapshot_2.GetOwnedBytes() << std::endl << std::endl;
+
+    std::cout << "---- Benchmark ----" << std::endl;
+    Benchmark(16 << 20, 256, 16);
+    Benchmark(16 << 20, 256, 256);
+}
@@ -0,0 +1,377 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+class VirtualMachine;
+
+// Mementor 클래스
+class Snapshot
+{
+private:
+    friend class VirtualMachine;
+
+    // 예시를 위해 간단하게 했지만, 실제로는 외부에 노출되면 안되는 많은 상태 정보들이
+    // 들어있을 것입니다.
+    struct State
+    {
+        std::uint16_t cpuCount{ 1 };
+        std::uint64_t ramSize{ 500 };
+        // ...
+    };
+
+    explicit Snapshot(State const& state)
+        : state_(state)
+    {}
+
+    State state_;
+};
+
+constexpr std::size_t kCacheLineSize = 64;
+
+// cache line 경계에서 시작하는 메모리를 할당합니다.
+template <typename T>
+struct CacheLineAllocator
+{
+    using value_type = T;
+
+    CacheLineAllocator() = default;
+
+    template <typename U>
+    CacheLineAllocator(CacheLineAllocator<U> const&) {}
+
+    T* allocate(std::size_t count)
+    {
+        void* data = nullptr;
+        if (::posix_memalign(&data, kCacheLineSize, count * sizeof(T)) != 0)
+        {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(data);
+    }
+
+    void deallocate(T* data, std::size_t) { std::free(data); }
+};
+
+template <typename T, typename U>
+bool operator==(CacheLineAllocator<T> const&, CacheLineAllocator<U> const&) { return true; }
+
+template <typename T, typename U>
+bool operator!=(CacheLineAllocator<T> const&, CacheLineAllocator<U> const&) { return false; }
+
+/*
+    여러 VirtualMachine 의 상태를 한 번에 담는 Mementor 클래스.
+    State 의 field 마다 하나의 연속된 배열 (column) 을 두고, 모든 column 을 하나의 buffer 에 담습니다.
+      count (8 bytes) | padding | cpuCount column | padding | ramSize column
+    buffer 와 각 column 은 cache line 경계에서 시작합니다.
+    같은 field 끼리 모여 있으므로 압축이 잘 되고, buffer 를 그대로 파일에 쓰거나 다시 읽을 수 있습니다.
+    buffer 의 내용이 무엇을 뜻하는지는 VirtualMachine 만 압니다.
+*/
+class FleetSnapshot
+{
+public:
+    using Buffer = std::vector<std::uint8_t, CacheLineAllocator<std::uint8_t>>;
+
+    explicit FleetSnapshot(std::size_t count)
+        : buffer_(GetRamSizeOffset_(count) + count * sizeof(std::uint64_t))
+    {
+        auto header = static_cast<std::uint64_t>(count);
+        std::memcpy(buffer_.data(), &header, sizeof(header));
+    }
+
+    // GetBuffer 로 꺼낸 buffer 로부터 다시 만듭니다.
+    explicit FleetSnapshot(Buffer buffer)
+        : buffer_(std::move(buffer))
+    {
+        std::uint64_t header = 0;
+        if (buffer_.size() < sizeof(header))
+        {
+            throw std::invalid_argument("Fleet snapshot buffer is too small.");
+        }
+        std::memcpy(&header, buffer_.data(), sizeof(header));
+
+        // VirtualMachine 하나마다 column 들에 10 bytes 가 필요하므로, 그보다 큰 count 는 크기를 계산하기 전에 거릅니다.
+        // (파일에서 읽은 count 가 터무니없이 크면, 크기를 계산하다가 overflow 가 일어날 수 있습니다.)
+        if (header > buffer_.size() / (sizeof(std::uint16_t) + sizeof(std::uint64_t)) ||
+            buffer_.size() != GetRamSizeOffset_(header) + header * sizeof(std::uint64_t))
+        {
+            throw std::invalid_argument("Fleet snapshot buffer size does not match its count.");
+        }
+    }
+
+    std::size_t GetCount() const
+    {
+        std::uint64_t header;
+        std::memcpy(&header, buffer_.data(), sizeof(header));
+        return static_cast<std::size_t>(header);
+    }
+
+    Buffer const& GetBuffer() const { return buffer_; }
+
+private:
+    friend class VirtualMachine;
+
+    static std::size_t AlignToCacheLine_(std::size_t offset)
+    {
+        return (offset + kCacheLineSize - 1) / kCacheLineSize * kCacheLineSize;
+    }
+
+    static std::size_t GetCpuCountOffset_() { return AlignToCacheLine_(sizeof(std::uint64_t)); }
+
+    static std::size_t GetRamSizeOffset_(std::size_t count)
+    {
+        return AlignToCacheLine_(GetCpuCountOffset_() + count * sizeof(std::uint16_t));
+    }
+
+    void CheckIndex_(std::size_t index) const
+    {
+        if (index >= GetCount())
+        {
+            throw std::out_of_range("Fleet snapshot index is out of range.");
+        }
+    }
+
+    std::uint16_t* GetCpuCounts_() { return reinterpret_cast<std::uint16_t*>(buffer_.data() + GetCpuCountOffset_()); }
+    std::uint16_t const* GetCpuCounts_() const { return reinterpret_cast<std::uint16_t const*>(buffer_.data() + GetCpuCountOffset_()); }
+    std::uint64_t* GetRamSizes_() { return reinterpret_cast<std::uint64_t*>(buffer_.data() + GetRamSizeOffset_(GetCount())); }
+    std::uint64_t const* GetRamSizes_() const { return reinterpret_cast<std::uint64_t const*>(buffer_.data() + GetRamSizeOffset_(GetCount())); }
+
+    Buffer buffer_;
+};
+
+// Originator 클래스
+class VirtualMachine
+{
+public:
+    std::uint16_t GetCpuCount() const { return state_.cpuCount; }
+    std::uint64_t GetRamSize() const { return state_.ramSize; }
+
+    std::uint16_t ChangeCpuCount(std::uint16_t cpuCount)
+    {
+        auto old = state_.cpuCount;
+        state_.cpuCount = cpuCount;
+        return old;
+    }
+
+    std::uint64_t ChangeRamSize(std::uint64_t ramSize)
+    {
+        auto old = state_.ramSize;
+        state_.ramSize = ramSize;
+        return old;
+    }
+
+    void ResetToSnapshot(Snapshot const& snapshot)
+    {
+        state_ = snapshot.state_;
+    }
+
+    // fleet snapshot 의 index 번째 VirtualMachine 의 상태로 되돌립니다.
+    void ResetToSnapshot(FleetSnapshot const& snapshot, std::size_t index)
+    {
+        snapshot.CheckIndex_(index);
+        state_.cpuCount = snapshot.GetCpuCounts_()[index];
+        state_.ramSize = snapshot.GetRamSizes_()[index];
+    }
+
+    Snapshot TakeSnapshot() const
+    {
+        return Snapshot(state_);
+    }
+
+    // fleet snapshot 의 index 번째 자리에 지금의 상태를 기록합니다.
+    void TakeSnapshot(FleetSnapshot& snapshot, std::size_t index) const
+    {
+        snapshot.CheckIndex_(index);
+        snapshot.GetCpuCounts_()[index] = state_.cpuCount;
+        snapshot.GetRamSizes_()[index] = state_.ramSize;
+    }
+
+private:
+    Snapshot::State state_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/*
+    VirtualMachine 들을 core 수만큼의 shard 로 나누어, 각 shard 를 다른 thread 에서 처리합니다.
+    shard 가 너무 작으면 thread 를 만드는 비용이 더 크므로, kMinShardSize 보다 작게 나누지 않습니다.
+*/
+constexpr std::size_t kMinShardSize = 16384;
+
+template <typename Function>
+void ForEachShard(std::size_t count, std::size_t shardCount, Function const& function)
+{
+    shardCount = shardCount ? shardCount : std::max(1u, std::thread::hardware_concurrency());
+    shardCount = std::max<std::size_t>(1, std::min(shardCount, count / kMinShardSize));
+
+    // column 들이 cache line 경계에서 시작하므로, 64 개 단위로 자르면 shard 경계가 cache line 을 나누어 갖지 않습니다.
+    auto shardSize = ((count + shardCount - 1) / shardCount + 63) / 64 * 64;
+
+    std::vector<std::thread> threads;
+    for (std::size_t shard = 1; shard < shardCount; ++shard)
+    {
+        auto begin = std::min(count, shard * shardSize);
+        auto end = std::min(count, begin + shardSize);
+        threads.emplace_back([&function, begin, end] { function(begin, end); });
+    }
+    function(0, std::min(count, shardSize));
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+// Caretaker 가 100k 번의 TakeSnapshot 대신 한 번에 부릅니다.
+FleetSnapshot TakeFleetSnapshot(std::vector<VirtualMachine> const& vms, std::size_t shardCount = 0)
+{
+    FleetSnapshot snapshot(vms.size());
+    ForEachShard(vms.size(), shardCount, [&](std::size_t begin, std::size_t end)
+    {
+        for (auto i = begin; i < end; ++i)
+        {
+            vms[i].TakeSnapshot(snapshot, i);
+        }
+    });
+    return snapshot;
+}
+
+void ResetFleetToSnapshot(std::vector<VirtualMachine>& vms, FleetSnapshot const& snapshot, std::size_t shardCount = 0)
+{
+    if (vms.size() != snapshot.GetCount())
+    {
+        throw std::invalid_argument("Fleet size does not match the snapshot.");
+    }
+
+    ForEachShard(vms.size(), shardCount, [&](std::size_t begin, std::size_t end)
+    {
+        for (auto i = begin; i < end; ++i)
+        {
+            vms[i].ResetToSnapshot(snapshot, i);
+        }
+    });
+}
+
+void PrintVmInfo(VirtualMachine const& vm)
+{
+    std::cout << "----------------" << std::endl;
+    std::cout << "Cpu Count : " << vm.GetCpuCount() << std::endl;
+    std::cout << "Ram Size  : " << vm.GetRamSize() << std::endl << std::endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Benchmark : VirtualMachine 마다 TakeSnapshot 을 불러서 Snapshot 들을 모으는 것과 비교합니다.
+
+void Benchmark(std::size_t vmCount, std::size_t repeatCount)
+{
+    std::vector<VirtualMachine> vms(vmCount);
+    for (std::size_t i = 0; i < vmCount; ++i)
+    {
+        vms[i].ChangeCpuCount(static_cast<std::uint16_t>(1 + i % 64));
+        vms[i].ChangeRamSize(512 * (1 + i % 32));
+    }
+
+    auto measure = [&](auto const& function)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t n = 0; n < repeatCount; ++n)
+            function();
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / repeatCount;
+    };
+
+    std::vector<Snapshot> snapshots;
+    auto perVmTime = measure([&]
+    {
+        snapshots.clear();
+        snapshots.reserve(vmCount);
+        for (auto const& vm : vms)
+            snapshots.push_back(vm.TakeSnapshot());
+    });
+    auto perVmRestoreTime = measure([&]
+    {
+        for (std::size_t i = 0; i < vmCount; ++i)
+            vms[i].ResetToSnapshot(snapshots[i]);
+    });
+
+    auto shardCount = std::max(1u, std::thread::hardware_concurrency());
+    FleetSnapshot fleet(0);
+    auto fleetTime = measure([&] { fleet = TakeFleetSnapshot(vms, 1); });
+    auto shardedTime = measure([&] { fleet = TakeFleetSnapshot(vms, shardCount); });
+
+    // 상태를 모두 바꾼 뒤, buffer 를 복사해서 (파일에 썼다가 읽은 것처럼) 다시 만든 snapshot 으로 되돌립니다.
+    for (auto& vm : vms)
+    {
+        vm.ChangeCpuCount(0);
+        vm.ChangeRamSize(0);
+    }
+    FleetSnapshot reloaded(FleetSnapshot::Buffer(fleet.GetBuffer()));
+    auto restoreTime = measure([&] { ResetFleetToSnapshot(vms, reloaded, shardCount); });
+
+    bool isCorrect = true;
+    for (std::size_t i = 0; i < vmCount; ++i)
+    {
+        isCorrect = isCorrect && vms[i].GetCpuCount() == 1 + i % 64 && vms[i].GetRamSize() == 512 * (1 + i % 32);
+    }
+
+    VirtualMachine single;
+    single.ResetToSnapshot(reloaded, vmCount / 2);
+    isCorrect = isCorrect && single.GetCpuCount() == vms[vmCount / 2].GetCpuCount();
+
+    // 범위 밖의 index 와, count 가 터무니없이 큰 buffer 는 거절해야 합니다.
+    try
+    {
+        single.ResetToSnapshot(reloaded, vmCount);
+        isCorrect = false;
+    }
+    catch (std::out_of_range const&)
+    {}
+    try
+    {
+        auto corrupted = reloaded.GetBuffer();
+        auto const count = ~std::uint64_t{ 0 } / sizeof(std::uint64_t);
+        std::memcpy(corrupted.data(), &count, sizeof(count));
+        FleetSnapshot{ std::move(corrupted) };
+        isCorrect = false;
+    }
+    catch (std::invalid_argument const&)
+    {}
+
+    std::cout << vmCount << " VMs, " << shardCount << " hardware thread(s)" << std::endl;
+    std::cout << "  per VM Snapshot : capture " << perVmTime << " us, restore " << perVmRestoreTime << " us, "
+        << ((vmCount * sizeof(Snapshot)) >> 10) << " KiB" << std::endl;
+    std::cout << "  fleet, 1 shard  : capture " << fleetTime << " us" << std::endl;
+    std::cout << "  fleet, sharded  : capture " << shardedTime << " us, restore " << restoreTime << " us, "
+        << (fleet.GetBuffer().size() >> 10) << " KiB -> " << (isCorrect ? "correct" : "WRONG") << std::endl;
+}
+
+int main()
+{
+    std::vector<VirtualMachine> vms(3);
+
+    for (auto const& vm : vms)
+        PrintVmInfo(vm);
+    auto snapshot_1 = TakeFleetSnapshot(vms);
+
+    vms[0].ChangeCpuCount(16);
+    vms[0].ChangeRamSize(1500);
+    vms[2].ChangeCpuCount(4);
+    PrintVmInfo(vms[0]);
+    auto snapshot_2 = TakeFleetSnapshot(vms);
+
+    ResetFleetToSnapshot(vms, snapshot_1);
+    PrintVmInfo(vms[0]);
+
+    // 한 VirtualMachine 만 되돌릴 수도 있습니다.
+    vms[2].ResetToSnapshot(snapshot_2, 2);
+    PrintVmInfo(vms[2]);
+
+    std::cout << "---- Benchmark ----" << std::endl;
+    Benchmark(100000, 200);
+    Benchmark(1000000, 20);
+}
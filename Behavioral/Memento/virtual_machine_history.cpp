@@ -0,0 +1,329 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+// Mementor 클래스
+class Snapshot
+{
+public:
+    // Caretaker 가 메모리 사용량을 계산할 수 있도록, 크기만 알려줍니다. (내용은 여전히 감춰져 있습니다.)
+    std::size_t GetSize() const { return sizeof(*this) + state_.memory.capacity(); }
+
+private:
+    friend class VirtualMachine;
+
+    // 예시를 위해 간단하게 했지만, 실제로는 외부에 노출되면 안되는 많은 상태 정보들이
+    // 들어있을 것입니다.
+    struct State
+    {
+        std::uint16_t cpuCount{ 1 };
+        std::uint64_t ramSize{ 500 };
+        std::vector<std::uint8_t> memory;
+        // ...
+    };
+
+    explicit Snapshot(State state)
+        : state_(std::move(state))
+    {}
+
+    State state_;
+};
+
+// Originator 클래스
+class VirtualMachine
+{
+public:
+    explicit VirtualMachine(std::size_t memorySize = 4096)
+    {
+        state_.memory.resize(memorySize);
+    }
+
+    std::uint16_t GetCpuCount() const { return state_.cpuCount; }
+    std::uint64_t GetRamSize() const { return state_.ramSize; }
+
+    std::uint16_t ChangeCpuCount(std::uint16_t cpuCount)
+    {
+        auto old = state_.cpuCount;
+        state_.cpuCount = cpuCount;
+        return old;
+    }
+
+    std::uint64_t ChangeRamSize(std::uint64_t ramSize)
+    {
+        auto old = state_.ramSize;
+        state_.ramSize = ramSize;
+        return old;
+    }
+
+    void WriteMemory(std::size_t offset, void const* data, std::size_t size)
+    {
+        if (offset + size > state_.memory.size())
+        {
+            throw std::out_of_range("Memory write is out of range.");
+        }
+        std::memcpy(state_.memory.data() + offset, data, size);
+    }
+
+    void ReadMemory(std::size_t offset, void* data, std::size_t size) const
+    {
+        if (offset + size > state_.memory.size())
+        {
+            throw std::out_of_range("Memory read is out of range.");
+        }
+        std::memcpy(data, state_.memory.data() + offset, size);
+    }
+
+    void ResetToSnapshot(Snapshot const& snapshot)
+    {
+        state_ = snapshot.state_;
+    }
+
+    Snapshot TakeSnapshot() const
+    {
+        return Snapshot(state_);
+    }
+
+private:
+    Snapshot::State state_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct HistoryEntry
+{
+    using Clock = std::chrono::steady_clock;
+
+    std::uint64_t sequence;
+    Clock::time_point timestamp;
+    Snapshot snapshot;
+};
+
+// 예산을 넘었을 때 어느 Snapshot 을 버릴지 고르는 Strategy.
+class EvictionStrategy
+{
+public:
+    virtual ~EvictionStrategy() = default;
+
+    // entries 는 오래된 순서이고 두 개 이상입니다. 가장 최근의 것 (마지막) 은 고를 수 없습니다.
+    virtual std::size_t SelectVictim(std::deque<HistoryEntry> const& entries) const = 0;
+};
+
+class OldestFirstEviction : public EvictionStrategy
+{
+public:
+    std::size_t SelectVictim(std::deque<HistoryEntry> const&) const override
+    {
+        return 0;
+    }
+};
+
+/*
+    최근의 것은 촘촘하게, 오래된 것일수록 듬성듬성하게 남겨서, 남은 Snapshot 들의 간격이
+    나이에 비례하도록 (지수적으로) 만듭니다.
+    어떤 Snapshot 을 버렸을 때 생기는 간격이 그 Snapshot 의 나이에 비해 가장 작은 것을 버립니다.
+    가장 오래된 것과 가장 최근의 것은 남깁니다. 고르는 데 O(n) 이 걸립니다.
+*/
+class ExponentialThinningEviction : public EvictionStrategy
+{
+public:
+    std::size_t SelectVictim(std::deque<HistoryEntry> const& entries) const override
+    {
+        if (entries.size() <= 2)
+        {
+            return 0;
+        }
+
+        auto newest = entries.back().sequence;
+        std::size_t victim = 1;
+        double bestScore = 0;
+        for (std::size_t i = 1; i + 1 < entries.size(); ++i)
+        {
+            auto gap = entries[i + 1].sequence - entries[i - 1].sequence;
+            auto age = newest - entries[i].sequence;
+            auto score = double(gap) / double(age);
+            if (i == 1 || score < bestScore)
+            {
+                victim = i;
+                bestScore = score;
+            }
+        }
+        return victim;
+    }
+};
+
+/*
+    Caretaker 클래스
+    Snapshot 들을 찍은 순서대로 보관하고, 모두 합친 크기가 예산을 넘으면 EvictionStrategy 가 고른 것부터 버립니다.
+    sequence 번호와 시각은 모두 찍은 순서대로 커지므로, 이진 탐색으로 O(log n) 에 찾습니다.
+    가장 최근의 Snapshot 은 예산보다 크더라도 남겨둡니다.
+*/
+class SnapshotHistory
+{
+public:
+    using Clock = HistoryEntry::Clock;
+
+    SnapshotHistory(std::size_t budget, std::unique_ptr<EvictionStrategy>&& strategy)
+        : budget_(budget), strategy_(std::move(strategy))
+    {}
+
+    std::uint64_t Push(Snapshot snapshot)
+    {
+        return Push(std::move(snapshot), Clock::now());
+    }
+
+    // 시각은 이전에 넣은 것보다 빠를 수 없습니다.
+    std::uint64_t Push(Snapshot snapshot, Clock::time_point timestamp)
+    {
+        if (!entries_.empty() && timestamp < entries_.back().timestamp)
+        {
+            throw std::invalid_argument("Snapshot timestamp must not go backwards.");
+        }
+
+        auto sequence = nextSequence_++;
+        size_ += snapshot.GetSize();
+        entries_.push_back({ sequence, timestamp, std::move(snapshot) });
+
+        while (size_ > budget_ && entries_.size() > 1)
+        {
+            auto victim = strategy_->SelectVictim(entries_);
+            if (victim + 1 >= entries_.size())
+            {
+                throw std::logic_error("The latest snapshot cannot be evicted.");
+            }
+            size_ -= entries_[victim].snapshot.GetSize();
+            entries_.erase(entries_.begin() + victim);
+        }
+        return sequence;
+    }
+
+    // 버려졌거나 아직 없는 번호라면 nullptr 를 돌려줍니다. (다음 Push 전까지만 유효합니다.)
+    Snapshot const* FindBySequence(std::uint64_t sequence) const
+    {
+        auto it = std::lower_bound(entries_.begin(), entries_.end(), sequence,
+                                   [](HistoryEntry const& entry, std::uint64_t value) { return entry.sequence < value; });
+        return it != entries_.end() && it->sequence == sequence ? &it->snapshot : nullptr;
+    }
+
+    // 주어진 시각이나 그 이전에 찍은 것들 중 가장 최근의 Snapshot 을 찾습니다. (다음 Push 전까지만 유효합니다.)
+    Snapshot const* FindAt(Clock::time_point timestamp) const
+    {
+        auto it = std::upper_bound(entries_.begin(), entries_.end(), timestamp,
+                                   [](Clock::time_point value, HistoryEntry const& entry) { return value < entry.timestamp; });
+        return it != entries_.begin() ? &std::prev(it)->snapshot : nullptr;
+    }
+
+    Snapshot const* GetLatest() const
+    {
+        return entries_.empty() ? nullptr : &entries_.back().snapshot;
+    }
+
+    std::size_t GetCount() const { return entries_.size(); }
+    std::size_t GetSize() const { return size_; }
+    std::deque<HistoryEntry> const& GetEntries() const { return entries_; }
+
+private:
+    std::size_t budget_;
+    std::unique_ptr<EvictionStrategy> strategy_;
+    std::deque<HistoryEntry> entries_;
+    std::size_t size_{ 0 };
+    std::uint64_t nextSequence_{ 0 };
+};
+
+void PrintVmInfo(VirtualMachine const& vm)
+{
+    std::uint64_t firstWord = 0;
+    vm.ReadMemory(0, &firstWord, sizeof(firstWord));
+
+    std::cout << "----------------" << std::endl;
+    std::cout << "Cpu Count : " << vm.GetCpuCount() << std::endl;
+    std::cout << "Ram Size  : " << vm.GetRamSize() << std::endl;
+    std::cout << "Memory[0] : " << firstWord << std::endl << std::endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Benchmark : 1 ms 마다 snapshot 을 찍는다고 보고, 예산 안에서 어떤 snapshot 들이 남는지와
+//             Push 와 찾기에 걸리는 시간을 잽니다. 각 snapshot 의 memory 에는 sequence 번호를 적어둡니다.
+
+void Benchmark(char const* name, std::unique_ptr<EvictionStrategy>&& strategy, std::size_t pushCount, std::size_t budget)
+{
+    VirtualMachine vm;
+    SnapshotHistory history(budget, std::move(strategy));
+    auto const origin = SnapshotHistory::Clock::time_point();
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::uint64_t i = 0; i < pushCount; ++i)
+    {
+        vm.WriteMemory(0, &i, sizeof(i));
+        history.Push(vm.TakeSnapshot(), origin + std::chrono::milliseconds(i));
+    }
+    auto pushTime = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    // 무작위 시각으로 찾은 snapshot 이, 그 시각이나 그 이전에 찍은 것들 중 남아있는 가장 최근의 것인지 확인합니다.
+    std::mt19937_64 random(42);
+    std::size_t const lookupCount = 1000000;
+    bool isCorrect = true;
+    std::uint64_t found = 0;
+    start = std::chrono::steady_clock::now();
+    for (std::size_t n = 0; n < lookupCount; ++n)
+    {
+        auto sequence = random() % pushCount;
+        if (auto* snapshot = history.FindAt(origin + std::chrono::milliseconds(sequence)))
+        {
+            vm.ResetToSnapshot(*snapshot);
+            std::uint64_t value = 0;
+            vm.ReadMemory(0, &value, sizeof(value));
+            isCorrect = isCorrect && value <= sequence && history.FindBySequence(value) == snapshot;
+            ++found;
+        }
+    }
+    auto lookupTime = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    auto const& entries = history.GetEntries();
+    std::cout << name << " : " << history.GetCount() << " kept (" << (history.GetSize() >> 10) << " KiB), push "
+        << pushTime / pushCount << " us, find + restore " << lookupTime / lookupCount << " ns, found "
+        << found << " -> " << (isCorrect ? "correct" : "WRONG") << std::endl;
+    std::cout << "  ages of kept snapshots (ms) :";
+    for (std::size_t i = 0; i < entries.size(); i += std::max<std::size_t>(1, entries.size() / 12))
+        std::cout << " " << entries.back().sequence - entries[entries.size() - 1 - i].sequence;
+    std::cout << " ... " << entries.back().sequence - entries.front().sequence << std::endl;
+}
+
+int main()
+{
+    VirtualMachine vm;
+    SnapshotHistory history(1 << 20, std::make_unique<OldestFirstEviction>());
+
+    PrintVmInfo(vm);
+    auto snapshot_1 = history.Push(vm.TakeSnapshot());
+
+    std::uint64_t value = 42;
+    vm.ChangeCpuCount(16);
+    vm.ChangeRamSize(1500);
+    vm.WriteMemory(0, &value, sizeof(value));
+    PrintVmInfo(vm);
+    auto snapshot_2 = history.Push(vm.TakeSnapshot());
+
+    vm.ResetToSnapshot(*history.FindBySequence(snapshot_1));
+    PrintVmInfo(vm);
+
+    value = 7;
+    vm.ChangeCpuCount(4);
+    vm.ChangeRamSize(6000);
+    vm.WriteMemory(0, &value, sizeof(value));
+    PrintVmInfo(vm);
+
+    vm.ResetToSnapshot(*history.FindBySequence(snapshot_2));
+    PrintVmInfo(vm);
+
+    std::cout << "---- Benchmark ----" << std::endl;
+    Benchmark("oldest first ", std::make_unique<OldestFirstEviction>(), 100000, 1 << 20);
+    Benchmark("thinning     ", std::make_unique<ExponentialThinningEviction>(), 100000, 1 << 20);
+}
@@ -0,0 +1,630 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+class VirtualMachine;
+class SnapshotStore;
+
+// Mementor 클래스
+class Snapshot
+{
+private:
+    friend class VirtualMachine;
+    friend class SnapshotStore;
+
+    // 예시를 위해 간단하게 했지만, 실제로는 외부에 노출되면 안되는 많은 상태 정보들이
+    // 들어있을 것입니다.
+    struct State
+    {
+        std::uint16_t cpuCount{ 1 };
+        std::uint64_t ramSize{ 500 };
+        std::vector<std::uint8_t> memory;
+        // ...
+    };
+
+    explicit Snapshot(State state)
+        : state_(std::move(state))
+    {}
+
+    State state_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/*
+    Snapshot 파일의 형식 (POSIX 에서만 동작합니다.)
+      FileHeader | Record | Record | ...
+    모든 Record 는 alignment 경계에서 시작하고, Record 의 memory 도 alignment 경계에서 시작합니다.
+    alignment 는 파일을 만들 때의 page 크기이고 FileHeader 에 기록됩니다. mmap 의 offset 으로 쓰이므로,
+    page 크기의 배수가 아닌 파일은 열 수 없습니다.
+    따라서 memory 부분을 그대로 mmap 해서, 파싱이나 복사 없이 VirtualMachine 의 memory 로 쓸 수 있습니다.
+      Record = RecordHeader | padding | memory (memorySize bytes) | padding
+*/
+namespace snapshot_file
+{
+
+constexpr std::uint32_t kMagic = 0x53534d56;        // "VMSS"
+constexpr std::uint32_t kRecordMagic = 0x52534d56;  // "VMSR"
+constexpr std::uint32_t kVersion = 1;
+
+struct FileHeader
+{
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint64_t alignment;
+};
+
+struct RecordHeader
+{
+    std::uint32_t magic;
+    std::uint16_t cpuCount;
+    std::uint16_t reserved;
+    std::uint64_t ramSize;
+    std::uint64_t memorySize;
+};
+
+inline std::uint64_t AlignUp(std::uint64_t value, std::uint64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace snapshot_file
+
+// 열린 파일을 공유하기 위한 handle. 마지막 사용자가 사라질 때 닫습니다.
+class FileHandle
+{
+public:
+    explicit FileHandle(int fd)
+        : fd_(fd)
+    {}
+
+    ~FileHandle() { ::close(fd_); }
+
+    FileHandle(FileHandle const&) = delete;
+    FileHandle& operator=(FileHandle const&) = delete;
+
+    int Get() const { return fd_; }
+
+private:
+    int fd_;
+};
+
+/*
+    SnapshotStore 에 저장된 Snapshot 을 가리킵니다.
+    header 만 읽어둔 상태이고, memory 는 ResetToSnapshot 할 때 mmap 됩니다.
+*/
+class StoredSnapshot
+{
+private:
+    friend class VirtualMachine;
+    friend class SnapshotStore;
+
+    StoredSnapshot(std::shared_ptr<FileHandle const> file, std::uint64_t memoryOffset,
+                   snapshot_file::RecordHeader const& header)
+        : file_(std::move(file)), memoryOffset_(memoryOffset), header_(header)
+    {}
+
+    std::shared_ptr<FileHandle const> file_;
+    std::uint64_t memoryOffset_;
+    snapshot_file::RecordHeader header_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/*
+    VirtualMachine 의 memory. 항상 mmap 으로 할당합니다.
+    새로 만든 memory 는 anonymous mapping 이고, 저장된 snapshot 으로부터 되돌린 memory 는
+    파일의 private mapping 입니다. private mapping 은 처음 접근하는 page 만 파일에서 읽고,
+    쓰는 page 는 copy-on-write 되므로 파일은 바뀌지 않습니다.
+*/
+class MemoryImage
+{
+public:
+    explicit MemoryImage(std::size_t size)
+        : size_(size)
+    {
+        if (size_ > 0)
+        {
+            data_ = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (data_ == MAP_FAILED)
+            {
+                throw std::system_error(errno, std::generic_category(), "Fail to allocate memory.");
+            }
+        }
+    }
+
+    static MemoryImage MapFile(int fd, std::uint64_t offset, std::size_t size)
+    {
+        MemoryImage image(0);
+        if (size > 0)
+        {
+            image.data_ = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, static_cast<off_t>(offset));
+            if (image.data_ == MAP_FAILED)
+            {
+                image.data_ = nullptr;
+                throw std::system_error(errno, std::generic_category(), "Fail to map snapshot.");
+            }
+            // 기본 readahead 는 page 하나를 읽을 때 수 MiB 를 함께 읽어서, 이웃한 Record 까지 불러옵니다.
+            // VirtualMachine 은 memory 를 무작위로 접근하므로, 접근한 page 만 읽도록 합니다.
+            ::madvise(image.data_, size, MADV_RANDOM);
+            image.size_ = size;
+        }
+        return image;
+    }
+
+    MemoryImage(MemoryImage&& other) noexcept
+        : data_(other.data_), size_(other.size_)
+    {
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+
+    MemoryImage& operator=(MemoryImage&& other) noexcept
+    {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        return *this;
+    }
+
+    ~MemoryImage()
+    {
+        if (data_)
+        {
+            ::munmap(data_, size_);
+        }
+    }
+
+    std::uint8_t* GetData() { return static_cast<std::uint8_t*>(data_); }
+    std::uint8_t const* GetData() const { return static_cast<std::uint8_t const*>(data_); }
+    std::size_t GetSize() const { return size_; }
+
+private:
+    void* data_{ nullptr };
+    std::size_t size_{ 0 };
+};
+
+// Originator 클래스
+class VirtualMachine
+{
+public:
+    explicit VirtualMachine(std::size_t memorySize = 1 << 20)
+        : memory_(memorySize)
+    {}
+
+    std::uint16_t GetCpuCount() const { return state_.cpuCount; }
+    std::uint64_t GetRamSize() const { return state_.ramSize; }
+    std::size_t GetMemorySize() const { return memory_.GetSize(); }
+
+    std::uint16_t ChangeCpuCount(std::uint16_t cpuCount)
+    {
+        auto old = state_.cpuCount;
+        state_.cpuCount = cpuCount;
+        return old;
+    }
+
+    std::uint64_t ChangeRamSize(std::uint64_t ramSize)
+    {
+        auto old = state_.ramSize;
+        state_.ramSize = ramSize;
+        return old;
+    }
+
+    void WriteMemory(std::size_t offset, void const* data, std::size_t size)
+    {
+        if (offset + size > memory_.GetSize())
+        {
+            throw std::out_of_range("Memory write is out of range.");
+        }
+        std::memcpy(memory_.GetData() + offset, data, size);
+    }
+
+    void ReadMemory(std::size_t offset, void* data, std::size_t size) const
+    {
+        if (offset + size > memory_.GetSize())
+        {
+            throw std::out_of_range("Memory read is out of range.");
+        }
+        std::memcpy(data, memory_.GetData() + offset, size);
+    }
+
+    void ResetToSnapshot(Snapshot const& snapshot)
+    {
+        state_.cpuCount = snapshot.state_.cpuCount;
+        state_.ramSize = snapshot.state_.ramSize;
+        if (memory_.GetSize() != snapshot.state_.memory.size())
+        {
+            memory_ = MemoryImage(snapshot.state_.memory.size());
+        }
+        std::memcpy(memory_.GetData(), snapshot.state_.memory.data(), memory_.GetSize());
+    }
+
+    // 파일을 읽지 않고 mmap 만 하므로, memory 의 크기와 관계없이 바로 끝납니다.
+    void ResetToSnapshot(StoredSnapshot const& snapshot)
+    {
+        state_.cpuCount = snapshot.header_.cpuCount;
+        state_.ramSize = snapshot.header_.ramSize;
+        memory_ = MemoryImage::MapFile(snapshot.file_->Get(), snapshot.memoryOffset_,
+                                       static_cast<std::size_t>(snapshot.header_.memorySize));
+    }
+
+    Snapshot TakeSnapshot() const
+    {
+        Snapshot::State state;
+        state.cpuCount = state_.cpuCount;
+        state.ramSize = state_.ramSize;
+        state.memory.assign(memory_.GetData(), memory_.GetData() + memory_.GetSize());
+        return Snapshot(std::move(state));
+    }
+
+private:
+    struct Registers_
+    {
+        std::uint16_t cpuCount{ 1 };
+        std::uint64_t ramSize{ 500 };
+    };
+
+    Registers_ state_;
+    MemoryImage memory_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/*
+    Snapshot 들을 하나의 파일에 이어서 저장하는 Caretaker 입니다.
+    파일을 열 때는 Record 의 header 들만 읽어서 목차를 만들고, memory 는 읽지 않습니다.
+    수천 개의 Snapshot 을 저장해도, 실제로 되돌린 Snapshot 의 접근한 page 만 메모리에 올라옵니다.
+    Save 는 memory 만 쓰고, Record 의 header 는 Sync 에서 memory 를 디스크에 내린 뒤에 씁니다.
+    따라서 디스크에 header 가 있는 Record 는 memory 도 온전하고, 중간에 멈췄다면 header 가 없는 Record 부터 버려집니다.
+    Sync 하기 전의 Snapshot 도 이 store 에서는 되돌릴 수 있지만, 파일을 다시 열면 보이지 않습니다. (소멸자에서 Sync 합니다.)
+*/
+class SnapshotStore
+{
+public:
+    using SnapshotId = std::size_t;
+
+    explicit SnapshotStore(std::string const& path)
+    {
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "Fail to open snapshot store.");
+        }
+        file_ = std::make_shared<FileHandle>(fd);
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "Fail to stat snapshot store.");
+        }
+        auto fileSize = static_cast<std::uint64_t>(st.st_size);
+        auto pageSize = static_cast<std::uint64_t>(::sysconf(_SC_PAGESIZE));
+
+        if (fileSize == 0)
+        {
+            alignment_ = pageSize;
+            snapshot_file::FileHeader header{ snapshot_file::kMagic, snapshot_file::kVersion, alignment_ };
+            WriteAt_(&header, sizeof(header), 0);
+            endOffset_ = alignment_;
+            return;
+        }
+
+        snapshot_file::FileHeader header{};
+        if (::pread(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) ||
+            header.magic != snapshot_file::kMagic || header.version != snapshot_file::kVersion)
+        {
+            throw std::runtime_error("Invalid snapshot store header.");
+        }
+        if (header.alignment == 0 || header.alignment % pageSize != 0)
+        {
+            throw std::runtime_error("Snapshot store alignment is not a multiple of the page size.");
+        }
+        alignment_ = header.alignment;
+
+        endOffset_ = alignment_;
+        while (endOffset_ + sizeof(snapshot_file::RecordHeader) <= fileSize)
+        {
+            // header 전체가 fileSize 안에 있으므로, 읽지 못하면 잘못된 Record 가 아니라 I/O 오류입니다.
+            // (여기서 멈추고 잘라내면 뒤의 온전한 Record 들까지 지워지므로, 예외를 던집니다.)
+            snapshot_file::RecordHeader record{};
+            ReadAt_(&record, sizeof(record), endOffset_);
+
+            auto memoryOffset = endOffset_ + alignment_;
+            if (record.magic != snapshot_file::kRecordMagic || memoryOffset + record.memorySize > fileSize)
+            {
+                break;
+            }
+
+            entries_.push_back({ memoryOffset, record });
+            endOffset_ = snapshot_file::AlignUp(memoryOffset + record.memorySize, alignment_);
+        }
+        syncedCount_ = entries_.size();
+
+        // 온전한 마지막 Record 뒤에 남은 것은 잘라냅니다. 남겨두면 그 자리에 새 Record 를 쓰다가 멈췄을 때,
+        // 예전 Record 의 header 가 덜 쓰여진 memory 를 가리키는 온전한 Record 처럼 보일 수 있습니다.
+        if (endOffset_ < fileSize && ::ftruncate(fd, static_cast<off_t>(endOffset_)) != 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "Fail to truncate snapshot store.");
+        }
+    }
+
+    ~SnapshotStore()
+    {
+        try
+        {
+            Sync();
+        }
+        catch (...)
+        {}
+    }
+
+    SnapshotStore(SnapshotStore const&) = delete;
+    SnapshotStore& operator=(SnapshotStore const&) = delete;
+
+    SnapshotId Save(Snapshot const& snapshot)
+    {
+        auto const& state = snapshot.state_;
+        snapshot_file::RecordHeader record{ snapshot_file::kRecordMagic, state.cpuCount, 0,
+                                            state.ramSize, state.memory.size() };
+        auto memoryOffset = endOffset_ + alignment_;
+
+        // header 는 memory 가 디스크에 내려간 뒤에, Sync 에서 씁니다.
+        WriteAt_(state.memory.data(), state.memory.size(), memoryOffset);
+
+        entries_.push_back({ memoryOffset, record });
+        endOffset_ = snapshot_file::AlignUp(memoryOffset + record.memorySize, alignment_);
+        return entries_.size() - 1;
+    }
+
+    // 지금까지 저장한 Snapshot 들을 디스크에 기록합니다.
+    void Sync()
+    {
+        // 디스크는 쓴 순서대로 기록한다는 보장이 없으므로, memory 를 먼저 내린 뒤에 header 들을 씁니다.
+        if (syncedCount_ < entries_.size())
+        {
+            SyncData_();
+            for (; syncedCount_ < entries_.size(); ++syncedCount_)
+            {
+                auto const& entry = entries_[syncedCount_];
+                WriteAt_(&entry.header, sizeof(entry.header), entry.memoryOffset - alignment_);
+            }
+        }
+        SyncData_();
+    }
+
+    // memory 를 읽지 않고, 되돌릴 때 mmap 할 수 있는 handle 만 돌려줍니다.
+    StoredSnapshot Load(SnapshotId id) const
+    {
+        auto const& entry = entries_.at(id);
+        return StoredSnapshot(file_, entry.memoryOffset, entry.header);
+    }
+
+    // Snapshot 전체를 읽어서 복사합니다. (파일이 사라져도 쓸 수 있어야 할 때 사용합니다.)
+    Snapshot ReadCopy(SnapshotId id) const
+    {
+        auto const& entry = entries_.at(id);
+        Snapshot::State state;
+        state.cpuCount = entry.header.cpuCount;
+        state.ramSize = entry.header.ramSize;
+        state.memory.resize(static_cast<std::size_t>(entry.header.memorySize));
+
+        ReadAt_(state.memory.data(), state.memory.size(), entry.memoryOffset);
+        return Snapshot(std::move(state));
+    }
+
+    std::size_t GetCount() const { return entries_.size(); }
+
+    // page cache 에서 이 파일을 내보냅니다. (cold restore 를 측정하기 위해 사용합니다. Sync 한 뒤에만 효과가 있습니다.)
+    void DropCache() const
+    {
+        ::posix_fadvise(file_->Get(), 0, 0, POSIX_FADV_DONTNEED);
+    }
+
+private:
+    struct Entry_
+    {
+        std::uint64_t memoryOffset;
+        snapshot_file::RecordHeader header;
+    };
+
+    void SyncData_()
+    {
+        if (::fdatasync(file_->Get()) != 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "Fail to sync snapshot store.");
+        }
+    }
+
+    void WriteAt_(void const* data, std::size_t size, std::uint64_t offset)
+    {
+        auto const* bytes = static_cast<char const*>(data);
+        while (size > 0)
+        {
+            auto written = ::pwrite(file_->Get(), bytes, size, static_cast<off_t>(offset));
+            if (written < 0)
+            {
+                throw std::system_error(errno, std::generic_category(), "Fail to write snapshot store.");
+            }
+            bytes += written;
+            size -= static_cast<std::size_t>(written);
+            offset += static_cast<std::uint64_t>(written);
+        }
+    }
+
+    void ReadAt_(void* data, std::size_t size, std::uint64_t offset) const
+    {
+        auto* bytes = static_cast<char*>(data);
+        while (size > 0)
+        {
+            auto result = ::pread(file_->Get(), bytes, size, static_cast<off_t>(offset));
+            if (result < 0)
+            {
+                throw std::system_error(errno, std::generic_category(), "Fail to read snapshot store.");
+            }
+            if (result == 0)
+            {
+                throw std::runtime_error("Snapshot store is shorter than expected.");
+            }
+            bytes += result;
+            size -= static_cast<std::size_t>(result);
+            offset += static_cast<std::uint64_t>(result);
+        }
+    }
+
+    std::shared_ptr<FileHandle> file_;
+    std::vector<Entry_> entries_;
+    std::size_t syncedCount_{ 0 };      //< header 까지 쓰여진 Record 의 수
+    std::uint64_t alignment_{ 0 };
+    std::uint64_t endOffset_{ 0 };
+};
+
+void PrintVmInfo(VirtualMachine const& vm)
+{
+    std::uint64_t firstWord = 0;
+    vm.ReadMemory(0, &firstWord, sizeof(firstWord));
+
+    std::cout << "----------------" << std::endl;
+    std::cout << "Cpu Count : " << vm.GetCpuCount() << std::endl;
+    std::cout << "Ram Size  : " << vm.GetRamSize() << std::endl;
+    std::cout << "Memory[0] : " << firstWord << std::endl << std::endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Benchmark : 저장된 Snapshot 들 중 무작위로 골라서 되돌리는 시간을 잽니다.
+//             cold 는 매번 page cache 를 비운 뒤, warm 은 page cache 에 올라와 있는 상태에서 잽니다.
+
+void Benchmark(std::string const& path, std::size_t snapshotCount, std::size_t memorySize)
+{
+    std::remove(path.c_str());
+
+    {
+        VirtualMachine vm(memorySize);
+        SnapshotStore store(path);
+        std::mt19937_64 random(42);
+        for (std::size_t i = 0; i < snapshotCount; ++i)
+        {
+            for (std::size_t n = 0; n < 16; ++n)
+            {
+                auto value = random();
+                vm.WriteMemory(random() % (memorySize / sizeof(value)) * sizeof(value), &value, sizeof(value));
+            }
+            vm.ChangeCpuCount(static_cast<std::uint16_t>(1 + i % 64));
+            store.Save(vm.TakeSnapshot());
+        }
+        store.Sync();
+    }
+
+    // 다시 열어서, header 들만 읽고 목차를 만듭니다.
+    auto start = std::chrono::steady_clock::now();
+    SnapshotStore store(path);
+    auto openTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    VirtualMachine vm;
+    std::mt19937_64 random(7);
+    std::size_t const restoreCount = 200;
+    std::uint64_t checksum = 0;
+    std::size_t touchedPageCount = 0;
+
+    auto touch = [&]
+    {
+        for (std::size_t n = 0; n < touchedPageCount; ++n)
+        {
+            std::uint64_t value = 0;
+            vm.ReadMemory(random() % (memorySize / 4096) * 4096, &value, sizeof(value));
+            checksum += value;
+        }
+    };
+
+    auto measure = [&](bool isCold, bool isMapped)
+    {
+        // warm 은 파일 전체를 한 번 읽어서 page cache 에 올려둔 뒤에 잽니다.
+        if (!isCold)
+        {
+            for (std::size_t id = 0; id < store.GetCount(); ++id)
+                store.ReadCopy(id);
+        }
+
+        double total = 0;
+        for (std::size_t n = 0; n < restoreCount; ++n)
+        {
+            auto id = random() % store.GetCount();
+            if (isCold)
+                store.DropCache();
+
+            auto begin = std::chrono::steady_clock::now();
+            if (isMapped)
+                vm.ResetToSnapshot(store.Load(id));
+            else
+                vm.ResetToSnapshot(store.ReadCopy(id));
+            touch();
+            total += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count();
+        }
+        return total / restoreCount;
+    };
+
+    std::cout << snapshotCount << " snapshots of " << (memorySize >> 10) << " KiB, open " << openTime << " ms" << std::endl;
+    for (std::size_t pageCount : { 1, 8, 64 })
+    {
+        touchedPageCount = pageCount;
+        std::cout << "  restore + read " << touchedPageCount << " pages" << std::endl;
+        std::cout << "    mmap      : warm " << measure(false, true) << " us, cold " << measure(true, true) << " us" << std::endl;
+        std::cout << "    read copy : warm " << measure(false, false) << " us, cold " << measure(true, false) << " us" << std::endl;
+    }
+    std::cout << "  (checksum " << checksum << ")" << std::endl;
+
+    std::remove(path.c_str());
+}
+
+int main()
+{
+    std::string const path = "vm_snapshots.bin";
+    std::remove(path.c_str());
+
+    VirtualMachine vm;
+    SnapshotStore::SnapshotId snapshot_1;
+    SnapshotStore::SnapshotId snapshot_2;
+    {
+        SnapshotStore store(path);
+
+        PrintVmInfo(vm);
+        snapshot_1 = store.Save(vm.TakeSnapshot());
+
+        std::uint64_t value = 42;
+        vm.ChangeCpuCount(16);
+        vm.ChangeRamSize(1500);
+        vm.WriteMemory(0, &value, sizeof(value));
+        PrintVmInfo(vm);
+        snapshot_2 = store.Save(vm.TakeSnapshot());
+        store.Sync();
+    }
+
+    // 프로세스가 다시 시작된 것처럼, 파일을 다시 열어서 되돌립니다.
+    SnapshotStore store(path);
+    vm.ResetToSnapshot(store.Load(snapshot_1));
+    PrintVmInfo(vm);
+
+    std::uint64_t value = 7;
+    vm.ChangeCpuCount(4);
+    vm.ChangeRamSize(6000);
+    vm.WriteMemory(0, &value, sizeof(value));
+    PrintVmInfo(vm);
+
+    vm.ResetToSnapshot(store.Load(snapshot_2));
+    PrintVmInfo(vm);
+    std::remove(path.c_str());
+
+    std::cout << "---- Benchmark ----" << std::endl;
+    Benchmark("vm_snapshots_benchmark.bin", 2000, 1 << 20);
+    Benchmark("vm_snapshots_benchmark.bin", 200, 16 << 20);
+}
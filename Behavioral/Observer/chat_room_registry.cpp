@@ -0,0 +1,375 @@
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../../AccessKey.h"
+
+class Observable;
+
+// 관찰자
+class Observer
+{
+public:
+    virtual ~Observer() = default;
+
+    virtual void Update(Observable& observable, const void* dataKey) = 0;
+
+protected:
+    design::AccessKey<Observer> GetAccessKey() { return {}; }
+};
+
+/*
+    관찰 대상
+    관찰자들은 Attach 한 순서대로 vector 에 모아두고, Notify 는 이 vector 를 앞에서부터 훑습니다.
+    Detach 는 자리를 nullptr (tombstone) 로 바꾸기만 하므로, Notify 도중에 (Update 안에서) 자기 자신이나
+    다른 관찰자를 Detach 해도 됩니다. Detach 된 관찰자가 아직 통지받지 않았다면, 이번 Notify 에서는 통지받지 않습니다.
+    Notify 도중에 Attach 된 관찰자는 다음 Notify 부터 통지받습니다.
+    tombstone 은 Notify 중이 아닐 때, 살아있는 관찰자 수만큼 쌓이면 한 번에 치웁니다.
+*/
+class Observable
+{
+public:
+    virtual ~Observable() = 0;
+
+    void Attach(Observer& observer)
+    {
+        if (indices_.emplace(&observer, observers_.size()).second)
+        {
+            observers_.push_back(&observer);
+        }
+    }
+
+    void Detach(Observer& observer)
+    {
+        auto it = indices_.find(&observer);
+        if (it == indices_.end())
+        {
+            return;
+        }
+
+        observers_[it->second] = nullptr;
+        indices_.erase(it);
+        ++tombstoneCount_;
+        CompactIfNeeded_();
+    }
+
+    void Notify(const void* dataKey)
+    {
+        {
+            NotifyGuard_ guard(notifyDepth_);
+
+            // Update 안에서 Attach 하면 vector 가 다시 할당될 수 있으므로, 매번 index 로 읽습니다.
+            auto const count = observers_.size();
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                if (auto* observer = observers_[i])
+                {
+                    observer->Update(*this, dataKey);
+                }
+            }
+        }
+        CompactIfNeeded_();
+    }
+
+    std::size_t GetObserverCount() const { return indices_.size(); }
+
+private:
+    // Update 가 다시 Notify 를 부를 수 있으므로, 깊이를 셉니다.
+    struct NotifyGuard_
+    {
+        explicit NotifyGuard_(int& depth) : depth(depth) { ++depth; }
+        ~NotifyGuard_() { --depth; }
+
+        int& depth;
+    };
+
+    void CompactIfNeeded_()
+    {
+        if (notifyDepth_ > 0 || tombstoneCount_ == 0 || tombstoneCount_ < indices_.size())
+        {
+            return;
+        }
+
+        observers_.erase(std::remove(observers_.begin(), observers_.end(), nullptr), observers_.end());
+        for (std::size_t i = 0; i < observers_.size(); ++i)
+        {
+            indices_[observers_[i]] = i;
+        }
+        tombstoneCount_ = 0;
+    }
+
+    std::vector<Observer*> observers_;                      //< Attach 한 순서. Detach 된 자리는 nullptr
+    std::unordered_map<Observer*, std::size_t> indices_;    //< 살아있는 관찰자의 observers_ 에서의 자리
+    std::size_t tombstoneCount_{ 0 };
+    int notifyDepth_{ 0 };
+};
+
+inline Observable::~Observable() = default;
+
+class ChatRoom : public Observable
+{
+public:
+    explicit ChatRoom(std::string name)
+        : name_(std::move(name))
+    {}
+
+    void SendMessage(std::string const& message)
+    {
+        Notify(&message);
+    }
+
+    std::string GetName() const { return name_; }
+
+    std::string const& GetDataFromKey(design::AccessKey<Observer>,
+                                      const void* dataKey)
+    {
+        assert(dataKey);
+        return *reinterpret_cast<std::string const*>(dataKey);
+    }
+
+private:
+    const std::string name_;
+};
+
+class User : public Observer
+{
+public:
+    explicit User(std::string name)
+        : name_(std::move(name))
+    {}
+
+    void Update(Observable& observable, const void* dataKey) override
+    {
+        auto& chatRoom = static_cast<ChatRoom&>(observable);
+        assert(chatRoomSet_.find(&chatRoom) != std::end(chatRoomSet_));
+
+        auto const& message = chatRoom.GetDataFromKey(GetAccessKey(), dataKey);
+        std::cout << "[" << name_ << "][" << chatRoom.GetName() << "] " << message << std::endl;
+
+        // 통지받는 도중에 방을 나가도 됩니다.
+        if (message == "Bye, " + name_)
+        {
+            LeaveChatRoom(chatRoom);
+        }
+    }
+
+    void JoinChatRoom(ChatRoom& chatRoom)
+    {
+        chatRoomSet_.insert(&chatRoom);
+        chatRoom.Attach(*this);
+    }
+
+    void LeaveChatRoom(ChatRoom& chatRoom)
+    {
+        chatRoomSet_.erase(&chatRoom);
+        chatRoom.Detach(*this);
+    }
+
+private:
+    std::string name_;
+    std::set<ChatRoom*> chatRoomSet_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Churn Test : Update 안에서 자기 자신이나 다음 관찰자를 Detach 하고, 새 관찰자를 Attach 합니다.
+//              Detach 된 관찰자는 통지받지 않고, 새로 Attach 된 관찰자는 다음 Notify 부터 통지받아야 합니다.
+
+class CountingObserver : public Observer
+{
+public:
+    void Update(Observable&, const void*) override
+    {
+        ++count;
+    }
+
+    std::uint64_t count{ 0 };
+};
+
+class ChurningObserver : public Observer
+{
+public:
+    ChurningObserver(std::size_t id, std::vector<ChurningObserver>& others, std::vector<CountingObserver>& spares)
+        : id_(id), others_(others), spares_(spares)
+    {}
+
+    void Update(Observable& observable, const void*) override
+    {
+        ++count;
+        if (id_ % 5 == 0 && id_ + 1 < others_.size())
+            observable.Detach(others_[id_ + 1]);
+        if (id_ % 7 == 0)
+            observable.Attach(spares_[id_ / 7]);
+        if (id_ % 3 == 0)
+            observable.Detach(*this);
+    }
+
+    std::uint64_t count{ 0 };
+
+private:
+    std::size_t id_;
+    std::vector<ChurningObserver>& others_;
+    std::vector<CountingObserver>& spares_;
+};
+
+bool RunChurnTest(std::size_t observerCount)
+{
+    ChatRoom chatRoom("ChurnRoom");
+    std::vector<CountingObserver> spares((observerCount + 6) / 7);
+    std::vector<ChurningObserver> observers;
+    observers.reserve(observerCount);
+    for (std::size_t i = 0; i < observerCount; ++i)
+    {
+        observers.emplace_back(i, observers, spares);
+        chatRoom.Attach(observers.back());
+    }
+
+    chatRoom.SendMessage("first");
+
+    // 앞의 관찰자가 먼저 통지받으면서 떼어낸 관찰자만 통지받지 못합니다.
+    // 남는 것은 통지받고 스스로 떠나지 않은 관찰자들과, 통지받은 관찰자들이 붙인 spare 들입니다.
+    bool isCorrect = true;
+    std::vector<bool> isNotified(observerCount);
+    std::size_t expectedCount = 0;
+    for (std::size_t i = 0; i < observerCount; ++i)
+    {
+        isNotified[i] = !(i > 0 && (i - 1) % 5 == 0 && isNotified[i - 1]);
+        isCorrect = isCorrect && observers[i].count == (isNotified[i] ? 1u : 0u);
+        if (isNotified[i] && i % 3 != 0)
+            ++expectedCount;
+        if (isNotified[i] && i % 7 == 0)
+            ++expectedCount;
+    }
+    isCorrect = isCorrect && chatRoom.GetObserverCount() == expectedCount;
+    for (auto const& spare : spares)
+        isCorrect = isCorrect && spare.count == 0;
+
+    // spare 들은 두 번째 Notify 부터, 각각 한 번씩 통지받습니다.
+    chatRoom.SendMessage("second");
+    for (std::size_t i = 0; i < observerCount; i += 7)
+        isCorrect = isCorrect && spares[i / 7].count == (isNotified[i] ? 1u : 0u);
+    for (auto const& observer : observers)
+        isCorrect = isCorrect && observer.count <= 2;
+
+    return isCorrect;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Benchmark : 한 방의 관찰자 수를 늘려가면서, std::set 을 쓰는 원래의 Observable 과 Notify 시간을 비교합니다.
+
+namespace tree
+{
+
+class Observable;
+
+class Observer
+{
+public:
+    virtual ~Observer() = default;
+
+    virtual void Update(Observable& observable, const void* dataKey) = 0;
+};
+
+class Observable
+{
+public:
+    void Attach(Observer& observer) { observerSet_.insert(&observer); }
+    void Detach(Observer& observer) { observerSet_.erase(&observer); }
+
+    void Notify(const void* dataKey)
+    {
+        for (auto& observer : observerSet_)
+        {
+            observer->Update(*this, dataKey);
+        }
+    }
+
+private:
+    std::set<Observer*> observerSet_;
+};
+
+class CountingObserver : public Observer
+{
+public:
+    void Update(Observable&, const void*) override
+    {
+        ++count;
+    }
+
+    std::uint64_t count{ 0 };
+};
+
+} // namespace tree
+
+class BenchmarkRoom : public Observable
+{
+};
+
+template <typename Room, typename Counter>
+double MeasureFanOut(std::size_t observerCount, std::size_t messageCount)
+{
+    Room room;
+    std::vector<Counter> observers(observerCount);
+    for (auto& observer : observers)
+        room.Attach(observer);
+
+    // 관찰자 10% 를 떼어내서, tombstone 이 남아있거나 (registry) 트리가 바뀐 (std::set) 상태에서 잽니다.
+    for (std::size_t i = 0; i < observerCount; i += 10)
+        room.Detach(observers[i]);
+
+    std::string const message = "message";
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t n = 0; n < messageCount; ++n)
+        room.Notify(&message);
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    std::uint64_t total = 0;
+    for (auto const& observer : observers)
+        total += observer.count;
+    if (total != (observerCount - (observerCount + 9) / 10) * messageCount)
+        std::cout << "WRONG count" << std::endl;
+
+    return elapsed / (messageCount * observerCount);
+}
+
+void Benchmark()
+{
+    for (std::size_t observerCount = 10; observerCount <= 1000000; observerCount *= 10)
+    {
+        auto messageCount = std::max<std::size_t>(1, 20000000 / observerCount);
+        auto setTime = MeasureFanOut<tree::Observable, tree::CountingObserver>(observerCount, messageCount);
+        auto registryTime = MeasureFanOut<BenchmarkRoom, CountingObserver>(observerCount, messageCount);
+        std::cout << observerCount << " observers : std::set " << setTime << " ns/update, registry "
+            << registryTime << " ns/update" << std::endl;
+    }
+}
+
+/*
+    Observer Pattern은 어떤 객체의 상태가 변할 때, 그 객체에 의존성을 가진 다른
+    객체들이 그 변화를 통지받고 자동으로 갱신될 수 있도록 해줍니다.
+*/
+int main()
+{
+    ChatRoom chatRoom_1("ChatRoom_1"), chatRoom_2("ChatRoom_2");
+    User user_1("User_1"), user_2("User_2"), user_3("User_3");
+
+    user_1.JoinChatRoom(chatRoom_1);
+    user_2.JoinChatRoom(chatRoom_2);
+    user_3.JoinChatRoom(chatRoom_1);
+    user_3.JoinChatRoom(chatRoom_2);
+
+    chatRoom_1.SendMessage("Hi, nice to meet you!");
+    chatRoom_2.SendMessage("I'm Taeguk Kwon!");
+    chatRoom_1.SendMessage("Bye, User_1");
+    chatRoom_1.SendMessage("Is anyone here?");
+
+    std::cout << "Churn test : " << (RunChurnTest(100000) ? "passed" : "FAILED") << std::endl;
+
+    std::cout << "---- Benchmark ----" << std::endl;
+    Benchmark();
+}